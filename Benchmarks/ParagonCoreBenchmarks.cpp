@@ -0,0 +1,264 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "ParagonCore/DistanceCurve.h"
+#include "ParagonCore/StopPrediction.h"
+#include "ParagonCore/CardinalDirection.h"
+#include "ParagonCore/FeatureIndex.h"
+
+using namespace ParagonCore;
+
+namespace
+{
+	std::vector<FCurveKey> MakeAcceleratingCurve(int NumKeys)
+	{
+		std::vector<FCurveKey> Keys(NumKeys);
+		for (int KeyIndex = 0; KeyIndex < NumKeys; KeyIndex++)
+		{
+			const float Alpha = (float)KeyIndex / (NumKeys - 1);
+			Keys[KeyIndex].Time = Alpha;
+			Keys[KeyIndex].Value = Alpha * Alpha * 200.f;
+		}
+		return Keys;
+	}
+
+	/** Distances a running start looks up, in a fixed random order so the branch predictor cannot learn them */
+	std::vector<float> MakeDistances(int NumDistances)
+	{
+		std::mt19937 Random(42);
+		std::uniform_real_distribution<float> Distribution(0.f, 200.f);
+		std::vector<float> Distances(NumDistances);
+		for (float& Distance : Distances)
+		{
+			Distance = Distribution(Random);
+		}
+		return Distances;
+	}
+
+	/** Inputs of one character of a crowd */
+	struct FCharacterInput
+	{
+		FVector3 Location;
+		FVector3 Velocity;
+		float InputYaw;
+		float ActorYaw;
+	};
+
+	std::vector<FCharacterInput> MakeCrowd(int NumCharacters)
+	{
+		std::mt19937 Random(7);
+		std::uniform_real_distribution<float> Yaw(-180.f, 180.f);
+		std::uniform_real_distribution<float> Speed(50.f, 600.f);
+		std::vector<FCharacterInput> Crowd(NumCharacters);
+		for (FCharacterInput& Character : Crowd)
+		{
+			Character.Location = FVector3(Yaw(Random) * 10.f, Yaw(Random) * 10.f, 0.f);
+			Character.Velocity = FVector3(Speed(Random), Speed(Random), 0.f);
+			Character.InputYaw = Yaw(Random);
+			Character.ActorYaw = Yaw(Random);
+		}
+		return Crowd;
+	}
+
+	/** Eight dimensions like the start and stop feature database: two trajectory points, velocity and foot phase */
+	const int NumFeatureDimensions = 8;
+
+	/**
+	 * Entries sampled along clips like the baked database, so they lie on curves instead of filling the space.
+	 * Thirty samples per clip, each clip drifts from a random start along a random direction.
+	 */
+	std::vector<float> MakeFeatures(int NumPoints, unsigned Seed)
+	{
+		const int SamplesPerClip = 30;
+		std::mt19937 Random(Seed);
+		std::uniform_real_distribution<float> Distribution(-300.f, 300.f);
+		std::uniform_real_distribution<float> Drift(-10.f, 10.f);
+		std::vector<float> Points(NumPoints * NumFeatureDimensions);
+		float Start[NumFeatureDimensions];
+		float Direction[NumFeatureDimensions];
+		for (int Row = 0; Row < NumPoints; Row++)
+		{
+			const int Sample = Row % SamplesPerClip;
+			for (int Dimension = 0; Dimension < NumFeatureDimensions; Dimension++)
+			{
+				if (Sample == 0)
+				{
+					Start[Dimension] = Distribution(Random);
+					Direction[Dimension] = Drift(Random);
+				}
+				Points[Row * NumFeatureDimensions + Dimension] = Start[Dimension] + Direction[Dimension] * Sample;
+			}
+		}
+		return Points;
+	}
+
+	/** Queries near random entries of the database */
+	std::vector<float> MakeQueries(const std::vector<float>& Points, int NumQueries, unsigned Seed)
+	{
+		const int NumPoints = (int)Points.size() / NumFeatureDimensions;
+		std::mt19937 Random(Seed);
+		std::uniform_int_distribution<int> Row(0, NumPoints - 1);
+		std::uniform_real_distribution<float> Noise(-20.f, 20.f);
+		std::vector<float> Queries(NumQueries * NumFeatureDimensions);
+		for (int QueryIndex = 0; QueryIndex < NumQueries; QueryIndex++)
+		{
+			const int Source = Row(Random);
+			for (int Dimension = 0; Dimension < NumFeatureDimensions; Dimension++)
+			{
+				Queries[QueryIndex * NumFeatureDimensions + Dimension] = Points[Source * NumFeatureDimensions + Dimension] + Noise(Random);
+			}
+		}
+		return Queries;
+	}
+}
+
+/** Binary search over the curve keys, the lookup of sequences that were not baked */
+static void BM_FindPositionFromDistanceCurve(benchmark::State& State)
+{
+	const std::vector<FCurveKey> Keys = MakeAcceleratingCurve((int)State.range(0));
+	const std::vector<float> Distances = MakeDistances(1024);
+
+	size_t Index = 0;
+	for (auto _ : State)
+	{
+		benchmark::DoNotOptimize(FindPositionFromDistanceCurve(Keys.data(), (int)Keys.size(), Distances[Index++ & 1023]));
+	}
+	State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_FindPositionFromDistanceCurve)->RangeMultiplier(4)->Range(8, 4096);
+
+/** Lookup in the baked table, should not depend on the number of samples */
+static void BM_EvaluateQuantizedTable(benchmark::State& State)
+{
+	const std::vector<FCurveKey> Keys = MakeAcceleratingCurve(64);
+	const int NumSamples = (int)State.range(0);
+	const float DistanceStep = 200.f / (NumSamples - 1);
+
+	std::vector<float> Times(NumSamples);
+	for (int SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+	{
+		Times[SampleIndex] = FindPositionFromDistanceCurve(Keys.data(), (int)Keys.size(), SampleIndex * DistanceStep);
+	}
+	std::vector<uint16_t> QuantizedTimes(NumSamples);
+	const FTimeQuantization Quantization = QuantizeTimes(Times.data(), NumSamples, QuantizedTimes.data());
+	const std::vector<float> Distances = MakeDistances(1024);
+
+	size_t Index = 0;
+	for (auto _ : State)
+	{
+		benchmark::DoNotOptimize(EvaluateQuantizedTable(QuantizedTimes.data(), NumSamples, Quantization, 0.f, 1.f / DistanceStep, Distances[Index++ & 1023]));
+	}
+	State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_EvaluateQuantizedTable)->RangeMultiplier(4)->Range(8, 4096);
+
+/** Braking stop prediction over friction and braking deceleration in whole units, the last argument selects the closed form */
+static void BM_PredictStopLocation(benchmark::State& State)
+{
+	const float Friction = (float)State.range(0);
+	const float Deceleration = (float)State.range(1);
+	const bool bClosedForm = State.range(2) != 0;
+	const FVector3 Velocity(600.f, 0.f, 0.f);
+
+	int Iterations = 0;
+	for (auto _ : State)
+	{
+		FVector3 StopLocation;
+		benchmark::DoNotOptimize(PredictStopLocation(StopLocation, FVector3(), Velocity, FVector3(), Friction, Deceleration, 1.f / 60.f, 100, bClosedForm, &Iterations));
+		benchmark::DoNotOptimize(StopLocation);
+	}
+	State.counters["Iterations"] = (double)Iterations;
+}
+BENCHMARK(BM_PredictStopLocation)->ArgsProduct({ { 1, 2, 8 }, { 0, 512, 2048 }, { 0, 1 } });
+
+/** Stop prediction with input acceleration, always simulated */
+static void BM_PredictStopLocationAccelerating(benchmark::State& State)
+{
+	const float Friction = (float)State.range(0);
+	const FVector3 Velocity(600.f, 0.f, 0.f);
+	const FVector3 Acceleration(-2048.f, 0.f, 0.f);
+
+	for (auto _ : State)
+	{
+		FVector3 StopLocation;
+		benchmark::DoNotOptimize(PredictStopLocation(StopLocation, FVector3(), Velocity, Acceleration, Friction, 2048.f, 1.f / 60.f, 100));
+		benchmark::DoNotOptimize(StopLocation);
+	}
+}
+BENCHMARK(BM_PredictStopLocationAccelerating)->Arg(1)->Arg(2)->Arg(8);
+
+static void BM_ClassifyCardinalDirection(benchmark::State& State)
+{
+	const std::vector<FCharacterInput> Crowd = MakeCrowd(1024);
+
+	size_t Index = 0;
+	for (auto _ : State)
+	{
+		const FCharacterInput& Character = Crowd[Index++ & 1023];
+		benchmark::DoNotOptimize(ClassifyCardinalDirection(Character.InputYaw, Character.ActorYaw));
+	}
+	State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_ClassifyCardinalDirection);
+
+/** The per character core work of a locomotion update over a crowd: classify, predict the stop and look the stop curve up */
+static void BM_CrowdUpdate(benchmark::State& State)
+{
+	const std::vector<FCharacterInput> Crowd = MakeCrowd((int)State.range(0));
+	const std::vector<FCurveKey> Keys = MakeAcceleratingCurve(64);
+
+	for (auto _ : State)
+	{
+		for (const FCharacterInput& Character : Crowd)
+		{
+			const FCardinalDirectionResult Cardinal = ClassifyCardinalDirection(Character.InputYaw, Character.ActorYaw);
+
+			FVector3 StopLocation;
+			PredictStopLocation(StopLocation, Character.Location, Character.Velocity, FVector3(), 2.f, 2048.f, 1.f / 60.f, 100);
+			const float StopDistance = (StopLocation - Character.Location).Size();
+
+			benchmark::DoNotOptimize(Cardinal);
+			benchmark::DoNotOptimize(FindPositionFromDistanceCurve(Keys.data(), (int)Keys.size(), StopDistance));
+		}
+	}
+	State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_CrowdUpdate)->RangeMultiplier(4)->Range(1, 4096);
+
+/** Brute force clip selection over the number of database entries */
+static void BM_FindNearestFeatureLinear(benchmark::State& State)
+{
+	const int NumPoints = (int)State.range(0);
+	const std::vector<float> Points = MakeFeatures(NumPoints, 19);
+	const std::vector<float> Queries = MakeQueries(Points, 1024, 23);
+
+	size_t Index = 0;
+	for (auto _ : State)
+	{
+		benchmark::DoNotOptimize(FindNearestFeatureLinear(Points.data(), NumPoints, NumFeatureDimensions, Queries.data() + (Index++ & 1023) * NumFeatureDimensions));
+	}
+	State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_FindNearestFeatureLinear)->RangeMultiplier(4)->Range(64, 16384);
+
+/** Clip selection through the kd-tree, reports the average number of entries compared */
+static void BM_FindNearestFeature(benchmark::State& State)
+{
+	const int NumPoints = (int)State.range(0);
+	std::vector<float> Points = MakeFeatures(NumPoints, 19);
+	const std::vector<float> Queries = MakeQueries(Points, 1024, 23);
+	std::vector<uint8_t> SplitDimensions(NumPoints);
+	BuildFeatureIndex(Points.data(), SplitDimensions.data(), NumPoints, NumFeatureDimensions);
+
+	size_t Index = 0;
+	double NumComparisons = 0.0;
+	for (auto _ : State)
+	{
+		const FNearestFeature Nearest = FindNearestFeature(Points.data(), SplitDimensions.data(), NumPoints, NumFeatureDimensions, Queries.data() + (Index++ & 1023) * NumFeatureDimensions);
+		NumComparisons += Nearest.NumComparisons;
+		benchmark::DoNotOptimize(Nearest);
+	}
+	State.SetItemsProcessed(State.iterations());
+	State.counters["Comparisons"] = benchmark::Counter(NumComparisons, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FindNearestFeature)->RangeMultiplier(4)->Range(64, 16384);
@@ -0,0 +1,128 @@
+#include "AimOffsetPoseCache.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "BonePose.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Animation/CustomAttributesRuntime.h"
+
+bool FAimOffsetPoseKey::Uses(const FObjectKey& Object) const
+{
+	if (Skeleton == Object)
+	{
+		return true;
+	}
+
+	for (const FObjectKey& Pose : Poses)
+	{
+		if (Pose == Object)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FAimOffsetPoseKey::IsStale() const
+{
+	if (Skeleton.ResolveObjectPtr() == nullptr)
+	{
+		return true;
+	}
+
+	// Unset poses are null keys and stay null
+	for (const FObjectKey& Pose : Poses)
+	{
+		if (Pose != FObjectKey() && Pose.ResolveObjectPtr() == nullptr)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FAimOffsetPoseKey::operator==(const FAimOffsetPoseKey& Other) const
+{
+	if (Skeleton != Other.Skeleton)
+	{
+		return false;
+	}
+
+	for (int32 Pose = 0; Pose < FAimOffsetPoseData::NumPoses; Pose++)
+	{
+		if (Poses[Pose] != Other.Poses[Pose])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FAimOffsetPoseCache& FAimOffsetPoseCache::Get()
+{
+	static FAimOffsetPoseCache Cache;
+	return Cache;
+}
+
+FAimOffsetPoseDataPtr FAimOffsetPoseCache::FindOrAdd(const USkeleton* Skeleton, const UAnimSequence* const* Poses)
+{
+	if (!Skeleton)
+	{
+		return nullptr;
+	}
+
+	FAimOffsetPoseKey Key;
+	Key.Skeleton = FObjectKey(Skeleton);
+	for (int32 Pose = 0; Pose < FAimOffsetPoseData::NumPoses; Pose++)
+	{
+		Key.Poses[Pose] = FObjectKey(Poses[Pose]);
+	}
+
+	return FindOrAddEntry(Key, [Skeleton, Poses]()
+	{
+		TSharedPtr<FAimOffsetPoseData, ESPMode::ThreadSafe> NewData = MakeShared<FAimOffsetPoseData, ESPMode::ThreadSafe>();
+
+		const int32 NumBones = Skeleton->GetReferenceSkeleton().GetNum();
+		NewData->NumBones = NumBones;
+		NewData->Transforms.Init(FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), FAimOffsetPoseData::NumPoses * NumBones);
+
+		TArray<FBoneIndexType> RequiredBoneIndices;
+		RequiredBoneIndices.SetNumUninitialized(NumBones);
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+		{
+			RequiredBoneIndices[BoneIndex] = BoneIndex;
+		}
+
+		// A bone container of the skeleton itself, so the extracted poses can be shared by every mesh of the skeleton
+		FBoneContainer BoneContainer(RequiredBoneIndices, FCurveEvaluationOption(false), *const_cast<USkeleton*>(Skeleton));
+
+		FCompactPose Pose;
+		Pose.SetBoneContainer(&BoneContainer);
+		FBlendedCurve Curve;
+		Curve.InitFrom(BoneContainer);
+		FStackCustomAttributes Attributes;
+		FAnimationPoseData PoseData(Pose, Curve, Attributes);
+
+		for (int32 PoseIndex = 0; PoseIndex < FAimOffsetPoseData::NumPoses; PoseIndex++)
+		{
+			const UAnimSequence* Sequence = Poses[PoseIndex];
+			if (!Sequence || Sequence->AdditiveAnimType != AAT_RotationOffsetMeshSpace || !Sequence->IsValidAdditive())
+			{
+				continue;
+			}
+
+			// Additive sequences extract as mesh space rotation deltas, the conversion is done here once instead of every frame
+			Sequence->GetAnimationPose(PoseData, FAnimExtractContext(0.f));
+
+			for (FCompactPoseBoneIndex BoneIndex : Pose.ForEachBoneIndex())
+			{
+				const int32 SkeletonBoneIndex = BoneContainer.GetSkeletonIndex(BoneIndex);
+				if (SkeletonBoneIndex != INDEX_NONE)
+				{
+					NewData->Transforms[PoseIndex * NumBones + SkeletonBoneIndex] = Pose[BoneIndex];
+				}
+			}
+		}
+
+		return NewData;
+	});
+}
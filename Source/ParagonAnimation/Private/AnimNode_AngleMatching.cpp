@@ -0,0 +1,156 @@
+#include "AnimNode_AngleMatching.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "ParagonAnimInstance.h"
+#include "ParagonAnimationBenchmark.h"
+#include "ParagonAnimationStats.h"
+
+FAnimNode_AngleMatching::FAnimNode_AngleMatching()
+	: Sequence(nullptr)
+	, CurveName(TEXT("TurnCurve"))
+	, RemainingYaw(0.f)
+	, bConsumeTurnYaw(true)
+	, BakedCurveSamples(FDistanceCurveTable::DefaultNumSamples)
+	, BakedSequence(nullptr)
+{
+}
+
+bool FAnimNode_AngleMatching::BakeAngleCurve()
+{
+	BakedCurve.Reset();
+	BakedSequence = nullptr;
+	BakedCurveName = NAME_None;
+
+	const FFloatCurve* AngleCurve = FDistanceCurveTable::FindCurve(Sequence, CurveName);
+	if (!AngleCurve)
+	{
+		return false;
+	}
+
+	BakedCurve.Build(*AngleCurve, BakedCurveSamples);
+	if (!BakedCurve.IsValid())
+	{
+		return false;
+	}
+
+	BakedSequence = Sequence;
+	BakedCurveName = CurveName;
+	return true;
+}
+
+float FAnimNode_AngleMatching::GetAngleCurveTime()
+{
+	const FDistanceCurveTable* Baked = (Sequence == BakedSequence && CurveName == BakedCurveName) ? &BakedCurve : nullptr;
+
+	// The registry owns the shared copy now, drop the one every instance got from the class defaults
+	if (CurveHandle.Update(Sequence, CurveName, Baked, BakedCurveSamples) && CurveHandle.HasData())
+	{
+		BakedCurve.Reset();
+	}
+
+	return CurveHandle.Evaluate(-FMath::Abs(RemainingYaw));
+}
+
+float FAnimNode_AngleMatching::GetCurrentAssetTime()
+{
+	return InternalTimeAccumulator;
+}
+
+float FAnimNode_AngleMatching::GetCurrentAssetLength()
+{
+	return Sequence ? Sequence->GetPlayLength() : 0.0f;
+}
+
+void FAnimNode_AngleMatching::Initialize_AnyThread(const FAnimationInitializeContext& Context)
+{
+	FAnimNode_AssetPlayerBase::Initialize_AnyThread(Context);
+	InternalTimeAccumulator = 0;
+
+	if (Sequence)
+	{
+		GetAngleCurveTime();
+	}
+}
+
+void FAnimNode_AngleMatching::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context)
+{
+}
+
+void FAnimNode_AngleMatching::UpdateAssetPlayer(const FAnimationUpdateContext& Context)
+{
+	PARAGON_BENCHMARK_SCOPE(NodeUpdate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonAngleMatchingUpdate);
+
+	GetEvaluateGraphExposedInputs().Execute(Context);
+
+	if ((Sequence != nullptr) && (Context.AnimInstanceProxy->IsSkeletonCompatible(Sequence->GetSkeleton())))
+	{
+		const float MoveDelta = Context.GetDeltaTime();
+
+		// Never plays backwards, a turn that was cut short keeps playing out
+		float Time = InternalTimeAccumulator;
+		const float Target = GetAngleCurveTime();
+		if (Target > Time)
+			Time = Target;
+		else
+			Time += MoveDelta;
+
+		Time = FMath::Min(Time, Sequence->GetPlayLength());
+
+		if (bConsumeTurnYaw && Time > InternalTimeAccumulator)
+		{
+			FParagonAnimInstanceProxy* ParagonProxy = FParagonAnimInstanceProxy::FromProxy(Context.AnimInstanceProxy);
+			const FFloatCurve* AngleCurve = ParagonProxy ? FDistanceCurveTable::FindCurve(Sequence, CurveName) : nullptr;
+			if (AngleCurve)
+			{
+				const float TurnedYaw = AngleCurve->Evaluate(Time) - AngleCurve->Evaluate(InternalTimeAccumulator);
+				ParagonProxy->ConsumeTurnYaw(FMath::Max(TurnedYaw, 0.f));
+			}
+		}
+
+		// The tick record advances the accumulator by PlayRate * RateScale * DeltaTime, which lands on the matched time
+		float PlayRate = 0.f;
+		if (MoveDelta > 0.f && !FMath::IsNearlyZero(Sequence->RateScale))
+		{
+			PlayRate = (Time - InternalTimeAccumulator) / (MoveDelta * Sequence->RateScale);
+		}
+		else
+		{
+			InternalTimeAccumulator = Time;
+		}
+
+		CreateTickRecordForNode(Context, Sequence, false, PlayRate);
+	}
+}
+
+void FAnimNode_AngleMatching::Evaluate_AnyThread(FPoseContext& Output)
+{
+	PARAGON_BENCHMARK_SCOPE(NodeEvaluate);
+
+	check(Output.AnimInstanceProxy != nullptr);
+	if ((Sequence != nullptr) && (Output.AnimInstanceProxy->IsSkeletonCompatible(Sequence->GetSkeleton())))
+	{
+		FAnimationPoseData AnimationPoseData(Output);
+		Sequence->GetAnimationPose(AnimationPoseData, FAnimExtractContext(InternalTimeAccumulator, Output.AnimInstanceProxy->ShouldExtractRootMotion()));
+	}
+	else
+	{
+		Output.ResetToRefPose();
+	}
+}
+
+void FAnimNode_AngleMatching::OverrideAsset(UAnimationAsset* NewAsset)
+{
+	if (UAnimSequenceBase* NewSequence = Cast<UAnimSequenceBase>(NewAsset))
+	{
+		Sequence = NewSequence;
+		CurveHandle.Reset();
+	}
+}
+
+void FAnimNode_AngleMatching::GatherDebugData(FNodeDebugData& DebugData)
+{
+	FString DebugLine = DebugData.GetNodeName(this);
+
+	DebugLine += FString::Printf(TEXT("('%s' Remaining Yaw: %.1f, Time: %.3f)"), *GetNameSafe(Sequence), RemainingYaw, InternalTimeAccumulator);
+	DebugData.AddDebugItem(DebugLine, true);
+}
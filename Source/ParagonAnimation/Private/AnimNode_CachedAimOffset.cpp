@@ -0,0 +1,147 @@
+#include "AnimNode_CachedAimOffset.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "AnimationRuntime.h"
+#include "ParagonAnimationBenchmark.h"
+#include "ParagonAnimationStats.h"
+
+FAimOffsetPoseSet::FAimOffsetPoseSet()
+	: LeftDown(nullptr)
+	, CenterDown(nullptr)
+	, RightDown(nullptr)
+	, LeftCenter(nullptr)
+	, CenterCenter(nullptr)
+	, RightCenter(nullptr)
+	, LeftUp(nullptr)
+	, CenterUp(nullptr)
+	, RightUp(nullptr)
+{
+}
+
+void FAimOffsetPoseSet::GetPoses(UAnimSequence** OutPoses) const
+{
+	OutPoses[(int32)EAimOffsetPose::LeftDown] = LeftDown;
+	OutPoses[(int32)EAimOffsetPose::CenterDown] = CenterDown;
+	OutPoses[(int32)EAimOffsetPose::RightDown] = RightDown;
+	OutPoses[(int32)EAimOffsetPose::LeftCenter] = LeftCenter;
+	OutPoses[(int32)EAimOffsetPose::CenterCenter] = CenterCenter;
+	OutPoses[(int32)EAimOffsetPose::RightCenter] = RightCenter;
+	OutPoses[(int32)EAimOffsetPose::LeftUp] = LeftUp;
+	OutPoses[(int32)EAimOffsetPose::CenterUp] = CenterUp;
+	OutPoses[(int32)EAimOffsetPose::RightUp] = RightUp;
+}
+
+bool FAimOffsetPoseSet::operator==(const FAimOffsetPoseSet& Other) const
+{
+	UAnimSequence* PosesA[FAimOffsetPoseData::NumPoses];
+	UAnimSequence* PosesB[FAimOffsetPoseData::NumPoses];
+	GetPoses(PosesA);
+	Other.GetPoses(PosesB);
+	return FMemory::Memcmp(PosesA, PosesB, sizeof(PosesA)) == 0;
+}
+
+FAnimNode_CachedAimOffset::FAnimNode_CachedAimOffset()
+	: Yaw(0.f)
+	, Pitch(0.f)
+	, YawRange(90.f)
+	, PitchRange(90.f)
+	, Alpha(1.f)
+{
+}
+
+void FAnimNode_CachedAimOffset::UpdatePoseData(const USkeleton* Skeleton)
+{
+	if (PoseData.IsValid() && !PoseData->IsStale() && ResolvedPoses == Poses)
+	{
+		return;
+	}
+
+	UAnimSequence* PoseArray[FAimOffsetPoseData::NumPoses];
+	Poses.GetPoses(PoseArray);
+	PoseData = FAimOffsetPoseCache::Get().FindOrAdd(Skeleton, PoseArray);
+	ResolvedPoses = Poses;
+}
+
+void FAnimNode_CachedAimOffset::Initialize_AnyThread(const FAnimationInitializeContext& Context)
+{
+	FAnimNode_Base::Initialize_AnyThread(Context);
+	BasePose.Initialize(Context);
+
+	// Extracting here keeps the decompression out of the first update
+	UpdatePoseData(Context.AnimInstanceProxy->GetSkeleton());
+}
+
+void FAnimNode_CachedAimOffset::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context)
+{
+	BasePose.CacheBones(Context);
+}
+
+void FAnimNode_CachedAimOffset::Update_AnyThread(const FAnimationUpdateContext& Context)
+{
+	GetEvaluateGraphExposedInputs().Execute(Context);
+	BasePose.Update(Context);
+
+	UpdatePoseData(Context.AnimInstanceProxy->GetSkeleton());
+}
+
+void FAnimNode_CachedAimOffset::Evaluate_AnyThread(FPoseContext& Output)
+{
+	BasePose.Evaluate(Output);
+
+	PARAGON_BENCHMARK_SCOPE(NodeEvaluate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonAimOffsetEvaluate);
+
+	const float ActualAlpha = FMath::Clamp(Alpha, 0.f, 1.f);
+	if (!PoseData.IsValid() || PoseData->NumBones == 0 || ActualAlpha <= ZERO_ANIMWEIGHT_THRESH)
+	{
+		return;
+	}
+
+	// Grid coordinates from 0 to 2, left to right and down to up
+	const float X = FMath::Clamp(Yaw / YawRange, -1.f, 1.f) + 1.f;
+	const float Y = FMath::Clamp(Pitch / PitchRange, -1.f, 1.f) + 1.f;
+	const int32 Column = FMath::Min(FMath::FloorToInt(X), 1);
+	const int32 Row = FMath::Min(FMath::FloorToInt(Y), 1);
+	const float FractionX = X - Column;
+	const float FractionY = Y - Row;
+
+	const int32 Corners[4] = { Row * 3 + Column, Row * 3 + Column + 1, (Row + 1) * 3 + Column, (Row + 1) * 3 + Column + 1 };
+	const float Weights[4] = { (1.f - FractionX) * (1.f - FractionY), FractionX * (1.f - FractionY), (1.f - FractionX) * FractionY, FractionX * FractionY };
+
+	FPoseContext AdditivePose(Output);
+	AdditivePose.ResetToAdditiveIdentity();
+
+	const FBoneContainer& RequiredBones = Output.Pose.GetBoneContainer();
+	for (FCompactPoseBoneIndex BoneIndex : AdditivePose.Pose.ForEachBoneIndex())
+	{
+		const int32 SkeletonBoneIndex = RequiredBones.GetSkeletonIndex(BoneIndex);
+		if (SkeletonBoneIndex == INDEX_NONE || SkeletonBoneIndex >= PoseData->NumBones)
+		{
+			continue;
+		}
+
+		FTransform Blended = PoseData->GetTransform(Corners[0], SkeletonBoneIndex) * ScalarRegister(Weights[0]);
+		for (int32 Corner = 1; Corner < 4; Corner++)
+		{
+			if (Weights[Corner] > ZERO_ANIMWEIGHT_THRESH)
+			{
+				Blended.AccumulateWithShortestRotation(PoseData->GetTransform(Corners[Corner], SkeletonBoneIndex), ScalarRegister(Weights[Corner]));
+			}
+		}
+		Blended.NormalizeRotation();
+		AdditivePose.Pose[BoneIndex] = Blended;
+	}
+
+	FAnimationPoseData OutputPoseData(Output);
+	const FAnimationPoseData AdditivePoseData(AdditivePose);
+	FAnimationRuntime::AccumulateMeshSpaceRotationAdditiveToLocalPose(OutputPoseData, AdditivePoseData, ActualAlpha);
+	Output.Pose.NormalizeRotations();
+}
+
+void FAnimNode_CachedAimOffset::GatherDebugData(FNodeDebugData& DebugData)
+{
+	FString DebugLine = DebugData.GetNodeName(this);
+
+	DebugLine += FString::Printf(TEXT("(Yaw: %.1f, Pitch: %.1f, Alpha: %.2f, Cached: %d)"), Yaw, Pitch, Alpha, PoseData.IsValid());
+	DebugData.AddDebugItem(DebugLine);
+	BasePose.GatherDebugData(DebugData);
+}
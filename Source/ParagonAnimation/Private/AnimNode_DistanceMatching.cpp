@@ -1,149 +1,315 @@
 #include "AnimNode_DistanceMatching.h"
 #include "Animation/AnimInstanceProxy.h"
+#include "Animation/AnimInstance.h"
+#include "Engine/World.h"
+#include "ParagonAnimStreamingSubsystem.h"
+#include "ParagonAnimationStats.h"
+#include "ParagonAnimationBenchmark.h"
 
-#pragma optimize("", off)
-
-namespace
+FDistanceMatchingLODSettings::FDistanceMatchingLODSettings()
+	: CurveUpdateInterval(1)
+	, TimeQuantization(0.f)
 {
-	float FindPositionFromDistanceCurve(const FFloatCurve& DistanceCurve, const float Distance, UAnimSequenceBase* InAnimSequence)
-	{
-		const TArray<FRichCurveKey>& Keys = DistanceCurve.FloatCurve.GetConstRefOfKeys();
-
-		const int32 NumKeys = Keys.Num();
-		if (NumKeys < 2)
-		{
-			return 0.f;
-		}
-
-		// Some assumptions: 
-		// - keys have unique values, so for a given value, it maps to a single position on the timeline of the animation.
-		// - key values are sorted in increasing order.
-
-#if ENABLE_ANIM_DEBUG
-		// verify assumptions in DEBUG
-		bool bIsSortedInIncreasingOrder = true;
-		bool bHasUniqueValues = true;
-		TMap<float, float> UniquenessMap;
-		UniquenessMap.Add(Keys[0].Value, Keys[0].Time);
-		for (int32 KeyIndex = 1; KeyIndex < Keys.Num(); KeyIndex++)
-		{
-			if (UniquenessMap.Find(Keys[KeyIndex].Value) != nullptr)
-			{
-				bHasUniqueValues = false;
-			}
-
-			UniquenessMap.Add(Keys[KeyIndex].Value, Keys[KeyIndex].Time);
-
-			if (Keys[KeyIndex].Value < Keys[KeyIndex - 1].Value)
-			{
-				bIsSortedInIncreasingOrder = false;
-			}
-		}
+}
 
-		if (!bIsSortedInIncreasingOrder || !bHasUniqueValues)
-		{
-			UE_LOG(LogAnimation, Warning, TEXT("ERROR: BAD DISTANCE CURVE: %s, bIsSortedInIncreasingOrder: %d, bHasUniqueValues: %d"),
-				*GetNameSafe(InAnimSequence), bIsSortedInIncreasingOrder, bHasUniqueValues);
-		}
-#endif
+FAnimNode_DistanceMatching::FAnimNode_DistanceMatching()
+	: Sequence(nullptr)
+	, Distance(0.0f)
+	, BakedCurveSamples(FDistanceCurveTable::DefaultNumSamples)
+	, bCachePose(true)
+	, BakedSequence(nullptr)
+	, bBakedStreamedSequence(false)
+	, ResolvedStreamedSequence(nullptr)
+	, LookupSequence(nullptr)
+	, LookupTime(0.f)
+	, LookupRate(0.f)
+	, TimeSinceLookup(0.f)
+	, UpdatesUntilLookup(0)
+	, TimeQuantization(0.f)
+	, BonesSerialNumber(0)
+	, BonesLODLevel(INDEX_NONE)
+	, bReduceBones(false)
+	, CachedSequence(nullptr)
+	, CachedTime(0.f)
+	, CachedRequiredBonesSerialNumber(0)
+	, bCachedRootMotion(false)
+	, bHasCachedPose(false)
+	, NumCacheHits(0)
+	, NumCacheMisses(0)
+{
+}
 
-		int32 first = 1;
-		int32 last = NumKeys - 1;
-		int32 count = last - first;
+bool FAnimNode_DistanceMatching::BakeDistanceCurve()
+{
+	BakedCurve.Reset();
+	BakedSequence = nullptr;
+	BakedCurveName = NAME_None;
+	bBakedStreamedSequence = false;
 
-		while (count > 0)
-		{
-			int32 step = count / 2;
-			int32 middle = first + step;
-
-			if (Distance > Keys[middle].Value)
-			{
-				first = middle + 1;
-				count -= step + 1;
-			}
-			else
-			{
-				count = step;
-			}
-		}
+	// The streamed clip plays most of the time, the fallback is searched at runtime
+	UAnimSequenceBase* SequenceToBake = StreamedSequence.IsNull() ? Sequence : StreamedSequence.LoadSynchronous();
 
-		const FRichCurveKey& KeyA = Keys[first - 1];
-		const FRichCurveKey& KeyB = Keys[first];
-		const float Diff = KeyB.Value - KeyA.Value;
-		const float Alpha = !FMath::IsNearlyZero(Diff) ? ((Distance - KeyA.Value) / Diff) : 0.f;
-		return FMath::Lerp(KeyA.Time, KeyB.Time, Alpha);
+	const FFloatCurve* DistanceCurve = FDistanceCurveTable::FindCurve(SequenceToBake, CurveName);
+	if (!DistanceCurve)
+	{
+		return false;
 	}
 
-	float GetDistanceCurveTime(UAnimSequenceBase* Sequence, const FName& CurveName, float Distance)
+	BakedCurve.Build(*DistanceCurve, BakedCurveSamples);
+	if (!BakedCurve.IsValid())
 	{
-		auto& Curves = Sequence->GetCurveData().FloatCurves;
+		return false;
+	}
 
-		for (int i = 0; i < Curves.Num(); i++)
-		{
-			if (Curves[i].Name.DisplayName == CurveName)
-			{
-				return FindPositionFromDistanceCurve(Curves[i], Distance, Sequence);
-			}
-		}
+	BakedSequence = StreamedSequence.IsNull() ? SequenceToBake : nullptr;
+	bBakedStreamedSequence = !StreamedSequence.IsNull();
+	BakedCurveName = CurveName;
+	return true;
+}
 
-		return 0;
+float FAnimNode_DistanceMatching::GetDistanceCurveTime()
+{
+	const UAnimSequenceBase* PlayedSequence = GetPlayedSequence();
+	const UAnimSequenceBase* BakedFor = bBakedStreamedSequence ? ResolvedStreamedSequence : BakedSequence;
+	const FDistanceCurveTable* Baked = (PlayedSequence == BakedFor && CurveName == BakedCurveName) ? &BakedCurve : nullptr;
+
+	// The registry owns the shared copy now, drop the one every instance got from the class defaults
+	if (CurveHandle.Update(PlayedSequence, CurveName, Baked, BakedCurveSamples) && CurveHandle.HasData())
+	{
+		BakedCurve.Reset();
 	}
+
+	return CurveHandle.Evaluate(Distance);
 }
 
-FAnimNode_DistanceMatching::FAnimNode_DistanceMatching()
-	: Sequence(nullptr)
-	, Distance(0.0f)
+const FDistanceMatchingLODSettings* FAnimNode_DistanceMatching::GetLODSettings(int32 LODLevel) const
 {
+	if (LODSettings.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	return &LODSettings[FMath::Clamp(LODLevel, 0, LODSettings.Num() - 1)];
 }
 
 float FAnimNode_DistanceMatching::GetCurrentAssetTime()
 {
-	return 0;
+	return InternalTimeAccumulator;
 }
 
 float FAnimNode_DistanceMatching::GetCurrentAssetLength()
 {
-	return Sequence ? Sequence->GetPlayLength() : 0.0f;
+	const UAnimSequenceBase* PlayedSequence = GetPlayedSequence();
+	return PlayedSequence ? PlayedSequence->GetPlayLength() : 0.0f;
+}
+
+void FAnimNode_DistanceMatching::PreUpdate(const UAnimInstance* InAnimInstance)
+{
+	UParagonAnimStreamingSubsystem* Streaming = UWorld::GetSubsystem<UParagonAnimStreamingSubsystem>(InAnimInstance->GetWorld());
+
+	// Resolved again every frame without holding a reference, so the subsystem can evict the clip and Sequence takes over until it is back
+	ResolvedStreamedSequence = Streaming ? Streaming->RequestSequence(StreamedSequence) : StreamedSequence.Get();
 }
 
 void FAnimNode_DistanceMatching::Initialize_AnyThread(const FAnimationInitializeContext& Context)
 {
 	FAnimNode_AssetPlayerBase::Initialize_AnyThread(Context);
 	InternalTimeAccumulator = 0;
+	TimeQuantization = 0.f;
+	LookupSequence = nullptr;
+	UpdatesUntilLookup = 0;
+
+	if (GetPlayedSequence())
+	{
+		GetDistanceCurveTime();
+	}
 }
 
 void FAnimNode_DistanceMatching::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context)
 {
+	UpdateRequiredBones(*Context.AnimInstanceProxy);
+}
+
+void FAnimNode_DistanceMatching::UpdateRequiredBones(const FAnimInstanceProxy& Proxy)
+{
+	const FBoneContainer& RequiredBones = Proxy.GetRequiredBones();
+	const int32 LODLevel = Proxy.GetLODLevel();
+	if (RequiredBones.GetSerialNumber() == BonesSerialNumber && LODLevel == BonesLODLevel)
+	{
+		return;
+	}
+
+	BonesSerialNumber = RequiredBones.GetSerialNumber();
+	BonesLODLevel = LODLevel;
+	bHasCachedPose = false;
+	bReduceBones = false;
+	ReducedToOutput.Reset();
+	ReducedBoneMap.Reset();
+
+	const FDistanceMatchingLODSettings* LOD = GetLODSettings(LODLevel);
+	UObject* Asset = RequiredBones.GetAsset();
+	if (!LOD || LOD->ExcludedBones.Num() == 0 || !Asset || !RequiredBones.IsValid())
+	{
+		return;
+	}
+
+	// Required bones are sorted, so parents are visited before their children
+	const FReferenceSkeleton& RefSkeleton = RequiredBones.GetReferenceSkeleton();
+	const TArray<FBoneIndexType>& BoneIndices = RequiredBones.GetBoneIndicesArray();
+	TBitArray<> Excluded(false, RefSkeleton.GetNum());
+	TArray<FBoneIndexType> KeptBoneIndices;
+	KeptBoneIndices.Reserve(BoneIndices.Num());
+
+	for (int32 CompactIndex = 0; CompactIndex < BoneIndices.Num(); CompactIndex++)
+	{
+		const int32 BoneIndex = BoneIndices[CompactIndex];
+		const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+
+		// The root carries root motion and is never excluded
+		Excluded[BoneIndex] = BoneIndex != 0 && ((ParentIndex != INDEX_NONE && Excluded[ParentIndex]) || LOD->ExcludedBones.Contains(RefSkeleton.GetBoneName(BoneIndex)));
+		if (!Excluded[BoneIndex])
+		{
+			ReducedBoneMap.Add(BoneIndex, KeptBoneIndices.Num());
+			KeptBoneIndices.Add(BoneIndices[CompactIndex]);
+			ReducedToOutput.Add(FCompactPoseBoneIndex(CompactIndex));
+		}
+	}
+
+	if (KeptBoneIndices.Num() == BoneIndices.Num())
+	{
+		ReducedToOutput.Reset();
+		ReducedBoneMap.Reset();
+		return;
+	}
+
+	// Curves are evaluated into the output curve directly, the reduced set does not need them
+	ReducedBones.InitializeTo(KeptBoneIndices, FCurveEvaluationOption(false), *Asset);
+	bReduceBones = true;
 }
 
 void FAnimNode_DistanceMatching::UpdateAssetPlayer(const FAnimationUpdateContext& Context)
 {
+	PARAGON_BENCHMARK_SCOPE(NodeUpdate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonDistanceMatchingUpdate);
+
 	GetEvaluateGraphExposedInputs().Execute(Context);
 
-	if (Sequence)
+	UAnimSequenceBase* PlayedSequence = GetPlayedSequence();
+
+	if ((PlayedSequence != nullptr) && (Context.AnimInstanceProxy->IsSkeletonCompatible(PlayedSequence->GetSkeleton())))
 	{
-		float Time = InternalTimeAccumulator;
-		float MoveDelta = Context.GetDeltaTime();
+		const FDistanceMatchingLODSettings* LOD = GetLODSettings(Context.AnimInstanceProxy->GetLODLevel());
+		TimeQuantization = LOD ? LOD->TimeQuantization : 0.f;
 
-		float Target = GetDistanceCurveTime(Sequence, CurveName, Distance);
-		if (Target > Time)
-			Time = Target;
-		else
-			Time += MoveDelta;
+		// Followers get their time from the group leader when the tick record is ticked, the lookup would be thrown away.
+		// Transition roles only join the group once at full weight, same as in CreateTickRecordForNode
+		const bool bInGroup = GroupName != NAME_None && (GroupRole < EAnimGroupRole::TransitionLeader || bHasBeenFullWeight);
+		const bool bFollower = bInGroup && (GroupRole == EAnimGroupRole::AlwaysFollower || GroupRole == EAnimGroupRole::TransitionFollower);
 
-		Time = FMath::Min(Time, Sequence->GetPlayLength());
+		float PlayRate = 1.f;
+		if (!bFollower)
+		{
+			PlayRate = GetDistanceMatchedPlayRate(Context, LOD);
+		}
 
+		CreateTickRecordForNode(Context, PlayedSequence, false, PlayRate);
+	}
+}
+
+float FAnimNode_DistanceMatching::GetDistanceMatchedPlayRate(const FAnimationUpdateContext& Context, const FDistanceMatchingLODSettings* LOD)
+{
+	const UAnimSequenceBase* PlayedSequence = GetPlayedSequence();
+	float Time = InternalTimeAccumulator;
+	float MoveDelta = Context.GetDeltaTime();
+
+	TimeSinceLookup += MoveDelta;
+
+	float Target;
+	if (!LOD || --UpdatesUntilLookup <= 0 || LookupSequence != PlayedSequence)
+	{
+		Target = GetDistanceCurveTime();
+		LookupRate = (LookupSequence == PlayedSequence && TimeSinceLookup > 0.f) ? FMath::Max((Target - LookupTime) / TimeSinceLookup, 0.f) : 0.f;
+		LookupSequence = PlayedSequence;
+		LookupTime = Target;
+		TimeSinceLookup = 0.f;
+		UpdatesUntilLookup = LOD ? LOD->CurveUpdateInterval : 1;
+	}
+	else
+	{
+		Target = LookupTime + LookupRate * TimeSinceLookup;
+	}
+
+	if (Target > Time)
+		Time = Target;
+	else
+		Time += MoveDelta;
+
+	Time = FMath::Min(Time, PlayedSequence->GetPlayLength());
+
+	// The tick record advances the accumulator by PlayRate * RateScale * DeltaTime, which lands on the matched time
+	const float RateScale = PlayedSequence->RateScale;
+	if (MoveDelta <= 0.f || FMath::IsNearlyZero(RateScale))
+	{
 		InternalTimeAccumulator = Time;
+		return 0.f;
 	}
+
+	return (Time - InternalTimeAccumulator) / (MoveDelta * RateScale);
 }
 
 void FAnimNode_DistanceMatching::Evaluate_AnyThread(FPoseContext& Output)
 {
+	PARAGON_BENCHMARK_SCOPE(NodeEvaluate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonDistanceMatchingEvaluate);
+
 	check(Output.AnimInstanceProxy != nullptr);
-	if ((Sequence != nullptr) && (Output.AnimInstanceProxy->IsSkeletonCompatible(Sequence->GetSkeleton())))
+
+	UAnimSequenceBase* PlayedSequence = GetPlayedSequence();
+	if ((PlayedSequence != nullptr) && (Output.AnimInstanceProxy->IsSkeletonCompatible(PlayedSequence->GetSkeleton())))
 	{
-		FAnimationPoseData AnimationPoseData(Output);
-		Sequence->GetAnimationPose(AnimationPoseData, FAnimExtractContext(InternalTimeAccumulator, Output.AnimInstanceProxy->ShouldExtractRootMotion()));
+		UpdateRequiredBones(*Output.AnimInstanceProxy);
+
+		const bool bExtractRootMotion = Output.AnimInstanceProxy->ShouldExtractRootMotion();
+		const float EvaluationTime = TimeQuantization > 0.f ? FMath::Min(FMath::GridSnap(InternalTimeAccumulator, TimeQuantization), PlayedSequence->GetPlayLength()) : InternalTimeAccumulator;
+		const uint16 RequiredBonesSerialNumber = Output.AnimInstanceProxy->GetRequiredBones().GetSerialNumber();
+
+		if (bCachePose && bHasCachedPose
+			&& CachedSequence == PlayedSequence
+			&& CachedTime == EvaluationTime
+			&& CachedRequiredBonesSerialNumber == RequiredBonesSerialNumber
+			&& bCachedRootMotion == bExtractRootMotion)
+		{
+			Output.Pose.CopyBonesFrom(CachedPose);
+			Output.Curve.CopyFrom(CachedCurve);
+			Output.CustomAttributes.CopyFrom(CachedAttributes);
+			NumCacheHits++;
+			INC_DWORD_STAT(STAT_ParagonPoseCacheHits);
+			return;
+		}
+
+		if (bReduceBones)
+		{
+			EvaluateReducedPose(Output, FAnimExtractContext(EvaluationTime, bExtractRootMotion));
+		}
+		else
+		{
+			FAnimationPoseData AnimationPoseData(Output);
+			PlayedSequence->GetAnimationPose(AnimationPoseData, FAnimExtractContext(EvaluationTime, bExtractRootMotion));
+		}
+
+		if (bCachePose)
+		{
+			CachedPose.CopyBonesFrom(Output.Pose);
+			CachedCurve.CopyFrom(Output.Curve);
+			CachedAttributes.CopyFrom(Output.CustomAttributes);
+			CachedSequence = PlayedSequence;
+			CachedTime = EvaluationTime;
+			CachedRequiredBonesSerialNumber = RequiredBonesSerialNumber;
+			bCachedRootMotion = bExtractRootMotion;
+			bHasCachedPose = true;
+			NumCacheMisses++;
+			INC_DWORD_STAT(STAT_ParagonPoseCacheMisses);
+		}
 	}
 	else
 	{
@@ -151,19 +317,53 @@ void FAnimNode_DistanceMatching::Evaluate_AnyThread(FPoseContext& Output)
 	}
 }
 
+void FAnimNode_DistanceMatching::EvaluateReducedPose(FPoseContext& Output, const FAnimExtractContext& ExtractContext)
+{
+	const UAnimSequenceBase* PlayedSequence = GetPlayedSequence();
+
+	// Curves are not bone data and go straight into the output, attributes are keyed by the reduced bones
+	FCompactPose ReducedPose;
+	ReducedPose.SetBoneContainer(&ReducedBones);
+	FStackCustomAttributes ReducedStackAttributes;
+	FAnimationPoseData ReducedPoseData(ReducedPose, Output.Curve, ReducedStackAttributes);
+	PlayedSequence->GetAnimationPose(ReducedPoseData, ExtractContext);
+
+	if (PlayedSequence->IsValidAdditive())
+	{
+		Output.Pose.ResetToAdditiveIdentity();
+	}
+	else
+	{
+		Output.Pose.ResetToRefPose();
+	}
+
+	for (const FCompactPoseBoneIndex BoneIndex : ReducedPose.ForEachBoneIndex())
+	{
+		Output.Pose[ReducedToOutput[BoneIndex.GetInt()]] = ReducedPose[BoneIndex];
+	}
+
+	ReducedAttributes.CopyFrom(ReducedStackAttributes);
+	FCustomAttributesRuntime::CopyAndRemapAttributes(ReducedAttributes, Output.CustomAttributes, ReducedBoneMap, Output.AnimInstanceProxy->GetRequiredBones());
+}
+
 void FAnimNode_DistanceMatching::OverrideAsset(UAnimationAsset* NewAsset)
 {
 	if (UAnimSequenceBase* NewSequence = Cast<UAnimSequenceBase>(NewAsset))
 	{
 		Sequence = NewSequence;
+		StreamedSequence.Reset();
+		ResolvedStreamedSequence = nullptr;
+		CurveHandle.Reset();
+		LookupSequence = nullptr;
 	}
 }
 
 void FAnimNode_DistanceMatching::GatherDebugData(FNodeDebugData& DebugData)
 {
 	FString DebugLine = DebugData.GetNodeName(this);
+	const UAnimSequenceBase* PlayedSequence = GetPlayedSequence();
 
-	DebugLine += FString::Printf(TEXT("('%s' Distance: %.3f, Time: %.3f)"), *GetNameSafe(Sequence), Distance, InternalTimeAccumulator);
+	DebugLine += FString::Printf(TEXT("('%s' Distance: %.3f, Time: %.3f, Pose Cache: %u/%u, Bones: %s)"), *GetNameSafe(PlayedSequence), Distance, InternalTimeAccumulator, NumCacheHits, NumCacheHits + NumCacheMisses,
+		bReduceBones ? *FString::FromInt(ReducedToOutput.Num()) : TEXT("all"));
 	DebugData.AddDebugItem(DebugLine, true);
 }
-#pragma optimize("", on)
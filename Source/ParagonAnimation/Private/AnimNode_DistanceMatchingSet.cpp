@@ -0,0 +1,116 @@
+#include "AnimNode_DistanceMatchingSet.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "ParagonAnimationBenchmark.h"
+#include "ParagonAnimationStats.h"
+
+FDistanceMatchingDirectionalClips::FDistanceMatchingDirectionalClips()
+	: North(nullptr)
+	, East(nullptr)
+	, South(nullptr)
+	, West(nullptr)
+{
+}
+
+UAnimSequenceBase* FDistanceMatchingDirectionalClips::Get(EAnimCardinalDirection Direction) const
+{
+	switch (Direction)
+	{
+	case EAnimCardinalDirection::North:
+		return North;
+	case EAnimCardinalDirection::East:
+		return East;
+	case EAnimCardinalDirection::South:
+		return South;
+	case EAnimCardinalDirection::West:
+		return West;
+	default:
+		return nullptr;
+	}
+}
+
+void FDistanceMatchingDirectionalClips::GetAll(TArray<UAnimSequenceBase*>& OutSequences) const
+{
+	for (UAnimSequenceBase* Sequence : { North, East, South, West })
+	{
+		if (Sequence)
+		{
+			OutSequences.AddUnique(Sequence);
+		}
+	}
+}
+
+FAnimNode_DistanceMatchingSet::FAnimNode_DistanceMatchingSet()
+	: Phase(EDistanceMatchingPhase::Start)
+	, Direction(EAnimCardinalDirection::North)
+	, StartDistance(0.f)
+	, StopDistance(0.f)
+	, BlendTime(0.2f)
+	, CurveSamples(FDistanceCurveTable::DefaultNumSamples)
+{
+}
+
+float FAnimNode_DistanceMatchingSet::GetCurrentAssetTime()
+{
+	return ClipStack.GetActive().Time;
+}
+
+float FAnimNode_DistanceMatchingSet::GetCurrentAssetLength()
+{
+	const UAnimSequenceBase* Sequence = ClipStack.GetActive().Sequence;
+	return Sequence ? Sequence->GetPlayLength() : 0.0f;
+}
+
+UAnimSequenceBase* FAnimNode_DistanceMatchingSet::GetSelectedSequence() const
+{
+	return (Phase == EDistanceMatchingPhase::Start ? StartClips : StopClips).Get(Direction);
+}
+
+void FAnimNode_DistanceMatchingSet::Initialize_AnyThread(const FAnimationInitializeContext& Context)
+{
+	FAnimNode_AssetPlayerBase::Initialize_AnyThread(Context);
+	GetEvaluateGraphExposedInputs().Execute(Context);
+
+	ClipStack.Reset(GetSelectedSequence(), Phase);
+
+	InternalTimeAccumulator = 0;
+}
+
+void FAnimNode_DistanceMatchingSet::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context)
+{
+}
+
+void FAnimNode_DistanceMatchingSet::UpdateAssetPlayer(const FAnimationUpdateContext& Context)
+{
+	PARAGON_BENCHMARK_SCOPE(NodeUpdate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonDistanceMatchingUpdate);
+
+	GetEvaluateGraphExposedInputs().Execute(Context);
+
+	UAnimSequenceBase* SelectedSequence = GetSelectedSequence();
+	if (SelectedSequence != ClipStack.GetActive().Sequence || Phase != ClipStack.GetActive().Phase)
+	{
+		ClipStack.Push(SelectedSequence, Phase);
+	}
+
+	ClipStack.Update(Context.GetDeltaTime(), BlendTime, StartDistance, StopDistance, CurveName, CurveSamples);
+
+	InternalTimeAccumulator = ClipStack.GetActive().Time;
+}
+
+void FAnimNode_DistanceMatchingSet::Evaluate_AnyThread(FPoseContext& Output)
+{
+	PARAGON_BENCHMARK_SCOPE(NodeEvaluate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonDistanceMatchingEvaluate);
+
+	ClipStack.Evaluate(Output);
+}
+
+void FAnimNode_DistanceMatchingSet::GatherDebugData(FNodeDebugData& DebugData)
+{
+	FString DebugLine = DebugData.GetNodeName(this);
+
+	DebugLine += TEXT("(");
+	ClipStack.GatherDebugData(DebugLine);
+	DebugLine += FString::Printf(TEXT("Start Distance: %.3f, Stop Distance: %.3f)"), StartDistance, StopDistance);
+	DebugData.AddDebugItem(DebugLine, true);
+}
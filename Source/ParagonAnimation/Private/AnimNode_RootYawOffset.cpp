@@ -0,0 +1,47 @@
+#include "AnimNode_RootYawOffset.h"
+#include "Animation/AnimInstanceProxy.h"
+
+FAnimNode_RootYawOffset::FAnimNode_RootYawOffset()
+	: Yaw(0.f)
+{
+}
+
+void FAnimNode_RootYawOffset::Initialize_AnyThread(const FAnimationInitializeContext& Context)
+{
+	FAnimNode_Base::Initialize_AnyThread(Context);
+	BasePose.Initialize(Context);
+}
+
+void FAnimNode_RootYawOffset::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context)
+{
+	BasePose.CacheBones(Context);
+}
+
+void FAnimNode_RootYawOffset::Update_AnyThread(const FAnimationUpdateContext& Context)
+{
+	GetEvaluateGraphExposedInputs().Execute(Context);
+	BasePose.Update(Context);
+}
+
+void FAnimNode_RootYawOffset::Evaluate_AnyThread(FPoseContext& Output)
+{
+	BasePose.Evaluate(Output);
+
+	if (!FMath::IsNearlyZero(Yaw))
+	{
+		// The root's parent is the component, so rotating it in local space rotates the whole pose around the component origin
+		const FQuat YawRotation(FVector::UpVector, FMath::DegreesToRadians(Yaw));
+		FTransform& RootTransform = Output.Pose[FCompactPoseBoneIndex(0)];
+		RootTransform.SetRotation(YawRotation * RootTransform.GetRotation());
+		RootTransform.SetTranslation(YawRotation.RotateVector(RootTransform.GetTranslation()));
+	}
+}
+
+void FAnimNode_RootYawOffset::GatherDebugData(FNodeDebugData& DebugData)
+{
+	FString DebugLine = DebugData.GetNodeName(this);
+
+	DebugLine += FString::Printf(TEXT("(Yaw: %.2f)"), Yaw);
+	DebugData.AddDebugItem(DebugLine);
+	BasePose.GatherDebugData(DebugData);
+}
@@ -0,0 +1,209 @@
+#include "AnimNode_StartStopMatching.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "ParagonAnimInstance.h"
+#include "ParagonAnimationBenchmark.h"
+#include "ParagonAnimationStats.h"
+
+namespace
+{
+	/** Where accelerating from Velocity along Acceleration, capped at MaxSpeed, takes the character after Time seconds */
+	FVector2D PredictStartDisplacement(const FVector2D& Velocity, const FVector2D& Acceleration, float MaxSpeed, float Time)
+	{
+		const float TimeStep = 1.f / 30.f;
+
+		FVector2D CurrentVelocity = Velocity;
+		FVector2D Displacement = FVector2D::ZeroVector;
+		for (float Elapsed = 0.f; Elapsed < Time; Elapsed += TimeStep)
+		{
+			const float StepTime = FMath::Min(TimeStep, Time - Elapsed);
+			CurrentVelocity += Acceleration * StepTime;
+			if (CurrentVelocity.SizeSquared() > FMath::Square(MaxSpeed))
+			{
+				CurrentVelocity = CurrentVelocity.GetSafeNormal() * MaxSpeed;
+			}
+			Displacement += CurrentVelocity * StepTime;
+		}
+		return Displacement;
+	}
+
+	/** Where constant deceleration that comes to rest at ToStop takes the character after Time seconds */
+	FVector2D PredictStopDisplacement(const FVector2D& Velocity, const FVector2D& ToStop, float Time)
+	{
+		const float Speed = Velocity.Size();
+		const float StopDistance = ToStop.Size();
+		if (Speed <= KINDA_SMALL_NUMBER || StopDistance <= KINDA_SMALL_NUMBER)
+		{
+			return ToStop;
+		}
+
+		const float Deceleration = Speed * Speed / (2.f * StopDistance);
+		const float StopTime = Speed / Deceleration;
+		const float Distance = Time < StopTime ? Speed * Time - 0.5f * Deceleration * Time * Time : StopDistance;
+		return ToStop * (Distance / StopDistance);
+	}
+}
+
+FAnimNode_StartStopMatching::FAnimNode_StartStopMatching()
+	: StartDistance(0.f)
+	, StopDistance(0.f)
+	, MaxSpeed(600.f)
+	, BlendTime(0.2f)
+	, CurveSamples(FDistanceCurveTable::DefaultNumSamples)
+	, bSelectPending(true)
+	, FootSeparation(ForceInitToZero)
+	, LastComparisons(0)
+{
+}
+
+float FAnimNode_StartStopMatching::GetCurrentAssetTime()
+{
+	return ClipStack.GetActive().Time;
+}
+
+float FAnimNode_StartStopMatching::GetCurrentAssetLength()
+{
+	const UAnimSequenceBase* Sequence = ClipStack.GetActive().Sequence;
+	return Sequence ? Sequence->GetPlayLength() : 0.0f;
+}
+
+#if WITH_EDITOR
+void FAnimNode_StartStopMatching::BakeFeatureDatabases()
+{
+	StartDatabase.Build(StartClips, false, FeatureSettings);
+	StopDatabase.Build(StopClips, true, FeatureSettings);
+}
+#endif // WITH_EDITOR
+
+void FAnimNode_StartStopMatching::PreUpdate(const UAnimInstance* InAnimInstance)
+{
+	const USkeletalMeshComponent* Mesh = InAnimInstance->GetSkelMeshComponent();
+	if (Mesh == nullptr)
+	{
+		return;
+	}
+
+	// Last frame's pose, the same moment the movement input was gathered
+	const TArray<FTransform>& ComponentSpaceTransforms = Mesh->GetComponentSpaceTransforms();
+	const int32 LeftFoot = Mesh->GetBoneIndex(FeatureSettings.LeftFootBone);
+	const int32 RightFoot = Mesh->GetBoneIndex(FeatureSettings.RightFootBone);
+	if (ComponentSpaceTransforms.IsValidIndex(LeftFoot) && ComponentSpaceTransforms.IsValidIndex(RightFoot))
+	{
+		FootSeparation = FVector2D(ComponentSpaceTransforms[LeftFoot].GetLocation() - ComponentSpaceTransforms[RightFoot].GetLocation());
+	}
+}
+
+void FAnimNode_StartStopMatching::Initialize_AnyThread(const FAnimationInitializeContext& Context)
+{
+	FAnimNode_AssetPlayerBase::Initialize_AnyThread(Context);
+	GetEvaluateGraphExposedInputs().Execute(Context);
+
+	ClipStack.Reset();
+	bSelectPending = true;
+
+	InternalTimeAccumulator = 0;
+}
+
+void FAnimNode_StartStopMatching::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context)
+{
+}
+
+void FAnimNode_StartStopMatching::SelectClip(const FParagonAnimInstanceProxy& ParagonProxy, const FQuat& MeshRotation, EDistanceMatchingPhase SelectPhase)
+{
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonClipSelection);
+
+	const FParagonLocomotionInput& Input = ParagonProxy.GetLocomotionInput();
+	const FParagonLocomotionState& State = ParagonProxy.GetLocomotionState();
+	if (!Input.bIsValid)
+	{
+		return;
+	}
+
+	const bool bStart = SelectPhase == EDistanceMatchingPhase::Start;
+	const FLocomotionFeatureDatabase& Database = bStart ? StartDatabase : StopDatabase;
+	const FLocomotionFeatureSettings& Settings = Database.Settings;
+
+	// The database is in component space
+	FLocomotionFeatureQuery Query;
+	Query.Velocity = FVector2D(MeshRotation.UnrotateVector(Input.Velocity));
+	Query.FootSeparation = FootSeparation;
+	if (bStart)
+	{
+		const FVector2D Acceleration(MeshRotation.UnrotateVector(Input.Acceleration));
+		Query.NearTrajectory = PredictStartDisplacement(Query.Velocity, Acceleration, MaxSpeed, Settings.NearTrajectoryTime);
+		Query.FarTrajectory = PredictStartDisplacement(Query.Velocity, Acceleration, MaxSpeed, Settings.FarTrajectoryTime);
+	}
+	else
+	{
+		Query.FarTrajectory = FVector2D(MeshRotation.UnrotateVector(State.DistanceMachingStopLocation - Input.ActorLocation));
+		Query.NearTrajectory = PredictStopDisplacement(Query.Velocity, Query.FarTrajectory, Settings.NearTrajectoryTime);
+	}
+
+	int32 ClipIndex = INDEX_NONE;
+	float ClipTime = 0.f;
+	LastComparisons = 0;
+	const bool bFound = Database.FindNearest(Query, ClipIndex, ClipTime, &LastComparisons);
+	INC_DWORD_STAT_BY(STAT_ParagonClipSelectionComparisons, LastComparisons);
+
+	const TArray<UAnimSequence*>& Clips = bStart ? StartClips : StopClips;
+	if (!bFound || !Clips.IsValidIndex(ClipIndex) || Clips[ClipIndex] == nullptr)
+	{
+		return;
+	}
+
+	FDistanceMatchedClipStack::FPlayer& Player = ClipStack.Push(Clips[ClipIndex], SelectPhase);
+	Player.Time = ClipTime;
+
+	// Stop distances count down to the rest pose and already match, start distances count up from the entry time
+	const FFloatCurve* DistanceCurve = bStart ? FDistanceCurveTable::FindCurve(Player.Sequence, CurveName) : nullptr;
+	if (DistanceCurve)
+	{
+		Player.DistanceOffset = DistanceCurve->Evaluate(ClipTime);
+	}
+}
+
+void FAnimNode_StartStopMatching::UpdateAssetPlayer(const FAnimationUpdateContext& Context)
+{
+	PARAGON_BENCHMARK_SCOPE(NodeUpdate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonDistanceMatchingUpdate);
+
+	GetEvaluateGraphExposedInputs().Execute(Context);
+
+	const float DeltaTime = Context.GetDeltaTime();
+
+	// Select where the instance saw acceleration start or stop, or when the node just became relevant
+	if (const FParagonAnimInstanceProxy* ParagonProxy = FParagonAnimInstanceProxy::FromProxy(Context.AnimInstanceProxy))
+	{
+		const FParagonLocomotionState& State = ParagonProxy->GetLocomotionState();
+		if (bSelectPending || State.bStartedThisUpdate || State.bStoppedThisUpdate)
+		{
+			// The component transform is last frame's, the mesh rotation it is about to get is already in the state
+			const FRotator MeshRotation = ParagonProxy->IsRotatingRootBone() ? ParagonProxy->GetLocomotionInput().BaseRotationOffset + State.ActorRotation : State.MeshRotation;
+			SelectClip(*ParagonProxy, MeshRotation.Quaternion(), State.IsAccelerating ? EDistanceMatchingPhase::Start : EDistanceMatchingPhase::Stop);
+		}
+	}
+	bSelectPending = false;
+
+	ClipStack.Update(DeltaTime, BlendTime, StartDistance, StopDistance, CurveName, CurveSamples);
+
+	InternalTimeAccumulator = ClipStack.GetActive().Time;
+}
+
+void FAnimNode_StartStopMatching::Evaluate_AnyThread(FPoseContext& Output)
+{
+	PARAGON_BENCHMARK_SCOPE(NodeEvaluate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonDistanceMatchingEvaluate);
+
+	ClipStack.Evaluate(Output);
+}
+
+void FAnimNode_StartStopMatching::GatherDebugData(FNodeDebugData& DebugData)
+{
+	FString DebugLine = DebugData.GetNodeName(this);
+
+	DebugLine += TEXT("(");
+	ClipStack.GatherDebugData(DebugLine);
+	DebugLine += FString::Printf(TEXT("Entries: %d/%d, Compared: %d)"), StartDatabase.Num(), StopDatabase.Num(), LastComparisons);
+	DebugData.AddDebugItem(DebugLine, true);
+}
@@ -0,0 +1,89 @@
+#include "DistanceCurveRegistry.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Animation/AnimCurveTypes.h"
+#include "ParagonAnimationStats.h"
+
+FDistanceCurveHandle::FDistanceCurveHandle()
+	: Sequence(nullptr)
+	, NumSamples(0)
+{
+}
+
+bool FDistanceCurveHandle::Update(const UAnimSequenceBase* InSequence, FName InCurveName, const FDistanceCurveTable* BakedTable, int32 InNumSamples)
+{
+	if (CurveData.IsValid() && !CurveData->IsStale() && Sequence == InSequence && CurveName == InCurveName && NumSamples == InNumSamples)
+	{
+		return false;
+	}
+
+	CurveData = FDistanceCurveRegistry::Get().FindOrAdd(InSequence, InCurveName, BakedTable, InNumSamples);
+	Sequence = InSequence;
+	CurveName = InCurveName;
+	NumSamples = InNumSamples;
+	return true;
+}
+
+float FDistanceCurveHandle::Evaluate(float Distance) const
+{
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonCurveLookup);
+	INC_DWORD_STAT(STAT_ParagonCurveLookups);
+
+	if (CurveData.IsValid() && CurveData->Table.IsValid())
+	{
+		return CurveData->Table.Evaluate(Distance);
+	}
+
+	const FFloatCurve* DistanceCurve = FDistanceCurveTable::FindCurve(Sequence, CurveName);
+	return DistanceCurve ? FDistanceCurveTable::EvaluateCurve(*DistanceCurve, Distance) : 0.f;
+}
+
+void FDistanceCurveHandle::Reset()
+{
+	CurveData.Reset();
+	Sequence = nullptr;
+	CurveName = NAME_None;
+	NumSamples = 0;
+}
+
+FDistanceCurveRegistry& FDistanceCurveRegistry::Get()
+{
+	static FDistanceCurveRegistry Registry;
+	return Registry;
+}
+
+FDistanceCurveDataPtr FDistanceCurveRegistry::FindOrAdd(const UAnimSequenceBase* Sequence, FName CurveName, const FDistanceCurveTable* BakedTable, int32 NumSamples)
+{
+	if (!Sequence)
+	{
+		return nullptr;
+	}
+
+	// Nodes that resample the same curve at different resolutions each get their own table
+	FDistanceCurveKey Key;
+	Key.Sequence = FObjectKey(Sequence);
+	Key.CurveName = CurveName;
+	Key.NumSamples = NumSamples;
+
+	return FindOrAddEntry(Key, [Sequence, CurveName, BakedTable, NumSamples]()
+	{
+		TSharedPtr<FDistanceCurveData, ESPMode::ThreadSafe> NewData = MakeShared<FDistanceCurveData, ESPMode::ThreadSafe>();
+		if (BakedTable && BakedTable->IsValid() && BakedTable->QuantizedTimes.Num() == NumSamples)
+		{
+			NewData->Table = *BakedTable;
+		}
+		else if (const FFloatCurve* DistanceCurve = FDistanceCurveTable::FindCurve(Sequence, CurveName))
+		{
+			NewData->Table.Build(*DistanceCurve, NumSamples);
+		}
+
+#if ENABLE_ANIM_DEBUG
+		// Reported once per curve instead of on every lookup, the anim blueprint compiler reports the offending keys
+		if (!NewData->Table.bValidCurve && FDistanceCurveTable::FindCurve(Sequence, CurveName))
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("Bad distance curve '%s' on %s, distances must strictly increase"), *CurveName.ToString(), *GetNameSafe(Sequence));
+		}
+#endif
+
+		return NewData;
+	});
+}
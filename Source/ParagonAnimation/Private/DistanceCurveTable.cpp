@@ -0,0 +1,212 @@
+#include "DistanceCurveTable.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Animation/AnimCurveTypes.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+FDistanceCurveTable::FDistanceCurveTable()
+	: TimeOffset(0.f)
+	, TimeScale(0.f)
+	, MinDistance(0.f)
+	, MaxDistance(0.f)
+	, InvDistanceStep(0.f)
+	, bValidCurve(false)
+{
+}
+
+void FDistanceCurveTable::Reset()
+{
+	QuantizedTimes.Reset();
+	MinDistance = 0.f;
+	MaxDistance = 0.f;
+	InvDistanceStep = 0.f;
+	TimeOffset = 0.f;
+	TimeScale = 0.f;
+	bValidCurve = false;
+}
+
+void FDistanceCurveTable::Build(const FFloatCurve& DistanceCurve, int32 NumSamples)
+{
+	Reset();
+
+	bValidCurve = Validate(DistanceCurve);
+
+	const TArray<FRichCurveKey>& Keys = DistanceCurve.FloatCurve.GetConstRefOfKeys();
+	if (Keys.Num() < 2 || NumSamples < 2)
+	{
+		return;
+	}
+
+	MinDistance = Keys[0].Value;
+	MaxDistance = Keys.Last().Value;
+	if (MaxDistance <= MinDistance)
+	{
+		return;
+	}
+
+	const float DistanceStep = (MaxDistance - MinDistance) / (NumSamples - 1);
+	InvDistanceStep = 1.f / DistanceStep;
+
+	TArray<float, TInlineAllocator<256>> Times;
+	Times.SetNumUninitialized(NumSamples);
+	for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+	{
+		Times[SampleIndex] = EvaluateCurve(DistanceCurve, MinDistance + SampleIndex * DistanceStep);
+	}
+
+	QuantizedTimes.SetNumUninitialized(NumSamples);
+	const ParagonCore::FTimeQuantization Quantization = ParagonCore::QuantizeTimes(Times.GetData(), NumSamples, QuantizedTimes.GetData());
+	TimeOffset = Quantization.TimeOffset;
+	TimeScale = Quantization.TimeScale;
+}
+
+const FFloatCurve* FDistanceCurveTable::FindCurve(const UAnimSequenceBase* Sequence, const FName& CurveName)
+{
+	if (!Sequence)
+	{
+		return nullptr;
+	}
+
+	const TArray<FFloatCurve>& Curves = Sequence->GetCurveData().FloatCurves;
+	for (int32 i = 0; i < Curves.Num(); i++)
+	{
+		if (Curves[i].Name.DisplayName == CurveName)
+		{
+			return &Curves[i];
+		}
+	}
+
+	return nullptr;
+}
+
+bool FDistanceCurveTable::Validate(const FFloatCurve& DistanceCurve, FString* OutError)
+{
+	const TArray<FRichCurveKey>& Keys = DistanceCurve.FloatCurve.GetConstRefOfKeys();
+	if (Keys.Num() < 2)
+	{
+		if (OutError)
+		{
+			*OutError = FString::Printf(TEXT("has %d keys, at least 2 are needed"), Keys.Num());
+		}
+		return false;
+	}
+
+	bool bIsSortedInIncreasingOrder = true;
+	bool bHasUniqueValues = true;
+	FString UnsortedKeys;
+	FString DuplicateKeys;
+
+	// Sorted values can only repeat their neighbour, so comparing neighbours covers both
+	for (int32 KeyIndex = 1; KeyIndex < Keys.Num(); KeyIndex++)
+	{
+		const float Value = Keys[KeyIndex].Value;
+		const float PreviousValue = Keys[KeyIndex - 1].Value;
+		if (Value < PreviousValue)
+		{
+			bIsSortedInIncreasingOrder = false;
+			if (OutError)
+			{
+				UnsortedKeys += FString::Printf(TEXT(" %.3f"), Keys[KeyIndex].Time);
+			}
+		}
+		else if (Value == PreviousValue)
+		{
+			bHasUniqueValues = false;
+			if (OutError)
+			{
+				DuplicateKeys += FString::Printf(TEXT(" %.3f"), Keys[KeyIndex].Time);
+			}
+		}
+	}
+
+	if (OutError)
+	{
+		OutError->Reset();
+		if (!bIsSortedInIncreasingOrder)
+		{
+			*OutError += FString::Printf(TEXT("decreases at keys [%s ]"), *UnsortedKeys);
+		}
+		if (!bHasUniqueValues)
+		{
+			*OutError += FString::Printf(TEXT("%srepeats the previous distance at keys [%s ]"), OutError->IsEmpty() ? TEXT("") : TEXT(", "), *DuplicateKeys);
+		}
+	}
+
+	return bIsSortedInIncreasingOrder && bHasUniqueValues;
+}
+
+float FDistanceCurveTable::EvaluateCurve(const FFloatCurve& DistanceCurve, const float Distance)
+{
+	const TArray<FRichCurveKey>& Keys = DistanceCurve.FloatCurve.GetConstRefOfKeys();
+
+	// Some assumptions, checked by Validate when the anim blueprint compiles and when the curve is prepared:
+	// - keys have unique values, so for a given value, it maps to a single position on the timeline of the animation.
+	// - key values are sorted in increasing order.
+	return ParagonCore::FindPositionFromDistanceCurve(Keys.GetData(), Keys.Num(), Distance);
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	/** Log the memory of the quantized table against the curve keys and its largest time error, for every loaded sequence with the curve */
+	void ReportDistanceCurves(const TArray<FString>& Args)
+	{
+		const FName CurveName = Args.Num() > 0 ? FName(*Args[0]) : FName(TEXT("DistanceCurve"));
+		const int32 NumSamples = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 2) : FDistanceCurveTable::DefaultNumSamples;
+
+		// Error is measured between the samples as well
+		const int32 NumErrorSamples = NumSamples * 8;
+
+		int32 NumSequences = 0;
+		SIZE_T TotalCurveBytes = 0;
+		SIZE_T TotalFloatTableBytes = 0;
+		SIZE_T TotalTableBytes = 0;
+		float TotalMaxError = 0.f;
+
+		for (TObjectIterator<UAnimSequenceBase> It; It; ++It)
+		{
+			const FFloatCurve* DistanceCurve = FDistanceCurveTable::FindCurve(*It, CurveName);
+			if (!DistanceCurve)
+			{
+				continue;
+			}
+
+			FDistanceCurveTable Table;
+			Table.Build(*DistanceCurve, NumSamples);
+			if (!Table.IsValid())
+			{
+				UE_LOG(LogAnimation, Display, TEXT("%s: curve '%s' could not be resampled"), *It->GetName(), *CurveName.ToString());
+				continue;
+			}
+
+			float MaxError = 0.f;
+			for (int32 SampleIndex = 0; SampleIndex < NumErrorSamples; SampleIndex++)
+			{
+				const float Distance = FMath::Lerp(Table.MinDistance, Table.MaxDistance, (float)SampleIndex / (NumErrorSamples - 1));
+				MaxError = FMath::Max(MaxError, FMath::Abs(Table.Evaluate(Distance) - FDistanceCurveTable::EvaluateCurve(*DistanceCurve, Distance)));
+			}
+
+			const SIZE_T CurveBytes = DistanceCurve->FloatCurve.GetConstRefOfKeys().Num() * sizeof(FRichCurveKey);
+			const SIZE_T FloatTableBytes = NumSamples * sizeof(float);
+			const SIZE_T TableBytes = Table.QuantizedTimes.Num() * sizeof(uint16) + sizeof(Table.TimeOffset) + sizeof(Table.TimeScale);
+
+			UE_LOG(LogAnimation, Display, TEXT("%s: %d keys %u bytes, float table %u bytes, quantized table %u bytes, max time error %.5f s (quantization step %.6f s)"),
+				*It->GetName(), DistanceCurve->FloatCurve.GetConstRefOfKeys().Num(), (uint32)CurveBytes, (uint32)FloatTableBytes, (uint32)TableBytes, MaxError, Table.TimeScale);
+
+			NumSequences++;
+			TotalCurveBytes += CurveBytes;
+			TotalFloatTableBytes += FloatTableBytes;
+			TotalTableBytes += TableBytes;
+			TotalMaxError = FMath::Max(TotalMaxError, MaxError);
+		}
+
+		UE_LOG(LogAnimation, Display, TEXT("Distance curves: %d sequences, keys %u bytes, float tables %u bytes, quantized tables %u bytes (%u saved over float), max time error %.5f s"),
+			NumSequences, (uint32)TotalCurveBytes, (uint32)TotalFloatTableBytes, (uint32)TotalTableBytes, (uint32)(TotalFloatTableBytes - TotalTableBytes), TotalMaxError);
+	}
+
+	FAutoConsoleCommand ReportDistanceCurvesCommand(
+		TEXT("Paragon.ReportDistanceCurves"),
+		TEXT("Log bytes and max time error of the quantized distance tables of all loaded sequences. Args: [CurveName] [NumSamples]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&ReportDistanceCurves));
+}
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,164 @@
+#include "DistanceMatchedClipStack.h"
+#include "Animation/AnimNodeBase.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "AnimationRuntime.h"
+#include "ParagonCore/BlendStack.h"
+
+namespace
+{
+	void EvaluatePlayer(const FDistanceMatchedClipStack::FPlayer& Player, FPoseContext& Output)
+	{
+		if ((Player.Sequence != nullptr) && (Output.AnimInstanceProxy->IsSkeletonCompatible(Player.Sequence->GetSkeleton())))
+		{
+			FAnimationPoseData AnimationPoseData(Output);
+			Player.Sequence->GetAnimationPose(AnimationPoseData, FAnimExtractContext(Player.Time, Output.AnimInstanceProxy->ShouldExtractRootMotion()));
+		}
+		else
+		{
+			Output.ResetToRefPose();
+		}
+	}
+}
+
+FDistanceMatchedClipStack::FDistanceMatchedClipStack()
+	: NumPlayers(1)
+{
+	Players[0].Weight = 1.f;
+}
+
+void FDistanceMatchedClipStack::Reset(UAnimSequenceBase* Sequence, EDistanceMatchingPhase Phase)
+{
+	NumPlayers = 1;
+
+	FPlayer& Player = Players[0];
+	Player = FPlayer();
+	Player.Sequence = Sequence;
+	Player.Phase = Phase;
+	Player.Weight = 1.f;
+}
+
+FDistanceMatchedClipStack::FPlayer& FDistanceMatchedClipStack::Push(UAnimSequenceBase* Sequence, EDistanceMatchingPhase Phase)
+{
+	// Nothing to blend out of
+	if (NumPlayers == 1 && Players[0].Sequence == nullptr)
+	{
+		Reset(Sequence, Phase);
+		return Players[0];
+	}
+
+	if (NumPlayers == MaxPlayers)
+	{
+		int32 Weakest = 0;
+		for (int32 PlayerIndex = 1; PlayerIndex < NumPlayers; PlayerIndex++)
+		{
+			if (Players[PlayerIndex].Weight < Players[Weakest].Weight)
+			{
+				Weakest = PlayerIndex;
+			}
+		}
+
+		const float RemainingWeight = 1.f - Players[Weakest].Weight;
+		for (int32 PlayerIndex = Weakest; PlayerIndex < NumPlayers - 1; PlayerIndex++)
+		{
+			Players[PlayerIndex] = MoveTemp(Players[PlayerIndex + 1]);
+		}
+		NumPlayers--;
+
+		for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; PlayerIndex++)
+		{
+			Players[PlayerIndex].Weight = RemainingWeight > 0.f ? Players[PlayerIndex].Weight / RemainingWeight : 1.f / NumPlayers;
+		}
+	}
+
+	FPlayer& Player = Players[NumPlayers++];
+	Player = FPlayer();
+	Player.Sequence = Sequence;
+	Player.Phase = Phase;
+	return Player;
+}
+
+void FDistanceMatchedClipStack::Update(float DeltaTime, float BlendTime, float StartDistance, float StopDistance, FName CurveName, int32 CurveSamples)
+{
+	// The clips below the active one fade out together from the weights they had, and leave the stack once they reach zero
+	const float BlendOutScale = ParagonCore::BlendInWeight(Players[NumPlayers - 1].Weight, BlendTime > 0.f ? DeltaTime / BlendTime : 1.f);
+
+	int32 NumKept = 0;
+	for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; PlayerIndex++)
+	{
+		FPlayer& Player = Players[PlayerIndex];
+		if (PlayerIndex < NumPlayers - 1)
+		{
+			Player.Weight *= BlendOutScale;
+			if (Player.Weight <= ZERO_ANIMWEIGHT_THRESH)
+			{
+				continue;
+			}
+		}
+
+		if (Player.Sequence)
+		{
+			Player.CurveHandle.Update(Player.Sequence, CurveName, nullptr, CurveSamples);
+
+			const float PlayerDistance = Player.Phase == EDistanceMatchingPhase::Start ? StartDistance + Player.DistanceOffset : StopDistance;
+			const float Target = Player.CurveHandle.Evaluate(PlayerDistance);
+
+			float Time = Player.Time;
+			if (Target > Time)
+				Time = Target;
+			else
+				Time += DeltaTime;
+
+			Player.Time = FMath::Min(Time, Player.Sequence->GetPlayLength());
+		}
+
+		if (NumKept != PlayerIndex)
+		{
+			Players[NumKept] = MoveTemp(Player);
+		}
+		NumKept++;
+	}
+	NumPlayers = NumKept;
+}
+
+void FDistanceMatchedClipStack::Evaluate(FPoseContext& Output) const
+{
+	check(Output.AnimInstanceProxy != nullptr);
+
+	EvaluatePlayers(NumPlayers, Output);
+}
+
+void FDistanceMatchedClipStack::EvaluatePlayers(int32 NumBlended, FPoseContext& Output) const
+{
+	const FPlayer& Newest = Players[NumBlended - 1];
+	if (NumBlended == 1)
+	{
+		EvaluatePlayer(Newest, Output);
+		return;
+	}
+
+	// The output must not alias an input of the blend, so the older players are blended into their own pose
+	float BlendedWeight = 0.f;
+	for (int32 PlayerIndex = 0; PlayerIndex < NumBlended; PlayerIndex++)
+	{
+		BlendedWeight += Players[PlayerIndex].Weight;
+	}
+
+	FPoseContext NewestPose(Output);
+	FPoseContext OlderPose(Output);
+	EvaluatePlayer(Newest, NewestPose);
+	EvaluatePlayers(NumBlended - 1, OlderPose);
+
+	const FAnimationPoseData NewestPoseData(NewestPose);
+	const FAnimationPoseData OlderPoseData(OlderPose);
+	FAnimationPoseData OutputPoseData(Output);
+	FAnimationRuntime::BlendTwoPosesTogether(NewestPoseData, OlderPoseData, BlendedWeight > 0.f ? Newest.Weight / BlendedWeight : 1.f, OutputPoseData);
+}
+
+void FDistanceMatchedClipStack::GatherDebugData(FString& DebugLine) const
+{
+	for (int32 PlayerIndex = NumPlayers - 1; PlayerIndex >= 0; PlayerIndex--)
+	{
+		const FPlayer& Player = Players[PlayerIndex];
+		DebugLine += FString::Printf(TEXT("'%s' Time: %.3f, Weight: %.2f, "), *GetNameSafe(Player.Sequence), Player.Time, Player.Weight);
+	}
+}
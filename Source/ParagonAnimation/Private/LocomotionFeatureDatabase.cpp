@@ -0,0 +1,195 @@
+#include "LocomotionFeatureDatabase.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "ParagonCore/FeatureIndex.h"
+
+FLocomotionFeatureSettings::FLocomotionFeatureSettings()
+	: NearTrajectoryTime(0.2f)
+	, FarTrajectoryTime(0.5f)
+	, EntryWindow(0.3f)
+	, SampleInterval(1.f / 30.f)
+	, LeftFootBone(TEXT("foot_l"))
+	, RightFootBone(TEXT("foot_r"))
+	, TrajectoryWeight(1.f)
+	, VelocityWeight(0.2f)
+	, FootPhaseWeight(1.f)
+{
+}
+
+FLocomotionFeatureQuery::FLocomotionFeatureQuery()
+	: NearTrajectory(ForceInitToZero)
+	, FarTrajectory(ForceInitToZero)
+	, Velocity(ForceInitToZero)
+	, FootSeparation(ForceInitToZero)
+{
+}
+
+#if WITH_EDITOR
+namespace
+{
+	/** Root position of the raw root track, the root has no parent so this is component space */
+	FVector GetRootLocation(const UAnimSequence* Sequence, float Time)
+	{
+		return Sequence->ExtractRootTrackTransform(FMath::Clamp(Time, 0.f, Sequence->SequenceLength), nullptr).GetLocation();
+	}
+
+	/** Compose the raw tracks from the bone up to the root, bones without a track keep their reference pose */
+	FVector GetComponentSpaceLocation(const UAnimSequence* Sequence, USkeleton* Skeleton, int32 SkeletonBoneIndex, float Time)
+	{
+		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+
+		FTransform ComponentSpace = FTransform::Identity;
+		for (int32 BoneIndex = SkeletonBoneIndex; BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetParentIndex(BoneIndex))
+		{
+			FTransform Local = RefSkeleton.GetRefBonePose()[BoneIndex];
+			const int32 TrackIndex = Skeleton->GetRawAnimationTrackIndex(BoneIndex, Sequence);
+			if (TrackIndex != INDEX_NONE)
+			{
+				Sequence->GetBoneTransform(Local, TrackIndex, Time, true);
+			}
+			ComponentSpace = ComponentSpace * Local;
+		}
+		return ComponentSpace.GetLocation();
+	}
+}
+#endif // WITH_EDITOR
+
+FLocomotionFeatureDatabase::FLocomotionFeatureDatabase()
+	: bHasFootPhase(false)
+{
+}
+
+void FLocomotionFeatureDatabase::Reset()
+{
+	Features.Reset();
+	SplitDimensions.Reset();
+	ClipIndices.Reset();
+	ClipTimes.Reset();
+	bHasFootPhase = false;
+}
+
+void FLocomotionFeatureDatabase::WriteFeatures(const FLocomotionFeatureQuery& Query, float* OutFeatures) const
+{
+	const float FootPhaseWeight = bHasFootPhase ? Settings.FootPhaseWeight : 0.f;
+
+	OutFeatures[0] = Query.NearTrajectory.X * Settings.TrajectoryWeight;
+	OutFeatures[1] = Query.NearTrajectory.Y * Settings.TrajectoryWeight;
+	OutFeatures[2] = Query.FarTrajectory.X * Settings.TrajectoryWeight;
+	OutFeatures[3] = Query.FarTrajectory.Y * Settings.TrajectoryWeight;
+	OutFeatures[4] = Query.Velocity.X * Settings.VelocityWeight;
+	OutFeatures[5] = Query.Velocity.Y * Settings.VelocityWeight;
+	OutFeatures[6] = Query.FootSeparation.X * FootPhaseWeight;
+	OutFeatures[7] = Query.FootSeparation.Y * FootPhaseWeight;
+}
+
+#if WITH_EDITOR
+void FLocomotionFeatureDatabase::Build(const TArray<UAnimSequence*>& Clips, bool bStopClips, const FLocomotionFeatureSettings& InSettings)
+{
+	Reset();
+	Settings = InSettings;
+
+	const float SampleInterval = FMath::Max(Settings.SampleInterval, 0.001f);
+
+	// Foot phase only counts if every clip can provide it
+	bHasFootPhase = Settings.FootPhaseWeight > 0.f;
+	for (const UAnimSequence* Sequence : Clips)
+	{
+		USkeleton* Skeleton = Sequence ? Sequence->GetSkeleton() : nullptr;
+		if (Skeleton && (Skeleton->GetReferenceSkeleton().FindBoneIndex(Settings.LeftFootBone) == INDEX_NONE || Skeleton->GetReferenceSkeleton().FindBoneIndex(Settings.RightFootBone) == INDEX_NONE))
+		{
+			bHasFootPhase = false;
+		}
+	}
+
+	TArray<FLocomotionFeatureQuery> Entries;
+	for (int32 ClipIndex = 0; ClipIndex < Clips.Num(); ClipIndex++)
+	{
+		const UAnimSequence* Sequence = Clips[ClipIndex];
+		USkeleton* Skeleton = Sequence ? Sequence->GetSkeleton() : nullptr;
+		if (Skeleton == nullptr || Sequence->GetRawAnimationData().Num() == 0)
+		{
+			continue;
+		}
+
+		const float Length = Sequence->SequenceLength;
+		const FVector EndLocation = GetRootLocation(Sequence, Length);
+		const int32 LeftFoot = Skeleton->GetReferenceSkeleton().FindBoneIndex(Settings.LeftFootBone);
+		const int32 RightFoot = Skeleton->GetReferenceSkeleton().FindBoneIndex(Settings.RightFootBone);
+
+		for (float Time = 0.f; Time <= FMath::Min(Settings.EntryWindow, Length); Time += SampleInterval)
+		{
+			const FVector Location = GetRootLocation(Sequence, Time);
+
+			FLocomotionFeatureQuery Entry;
+			Entry.NearTrajectory = FVector2D(GetRootLocation(Sequence, Time + Settings.NearTrajectoryTime) - Location);
+			Entry.FarTrajectory = FVector2D((bStopClips ? EndLocation : GetRootLocation(Sequence, Time + Settings.FarTrajectoryTime)) - Location);
+
+			const float VelocityStart = FMath::Max(Time - SampleInterval, 0.f);
+			const float VelocityEnd = FMath::Min(Time + SampleInterval, Length);
+			if (VelocityEnd > VelocityStart)
+			{
+				Entry.Velocity = FVector2D(GetRootLocation(Sequence, VelocityEnd) - GetRootLocation(Sequence, VelocityStart)) / (VelocityEnd - VelocityStart);
+			}
+
+			if (bHasFootPhase)
+			{
+				Entry.FootSeparation = FVector2D(GetComponentSpaceLocation(Sequence, Skeleton, LeftFoot, Time) - GetComponentSpaceLocation(Sequence, Skeleton, RightFoot, Time));
+			}
+
+			Entries.Add(Entry);
+			ClipIndices.Add(ClipIndex);
+			ClipTimes.Add(Time);
+		}
+	}
+
+	Features.SetNumUninitialized(Entries.Num() * NumDimensions);
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); EntryIndex++)
+	{
+		WriteFeatures(Entries[EntryIndex], Features.GetData() + EntryIndex * NumDimensions);
+	}
+
+	// Reorder the entries along with their features
+	TArray<int32> Order;
+	Order.SetNumUninitialized(Entries.Num());
+	SplitDimensions.SetNumZeroed(Entries.Num());
+	ParagonCore::BuildFeatureIndex(Features.GetData(), SplitDimensions.GetData(), Entries.Num(), NumDimensions, Order.GetData());
+
+	const TArray<int32> UnorderedClipIndices = ClipIndices;
+	const TArray<float> UnorderedClipTimes = ClipTimes;
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); EntryIndex++)
+	{
+		ClipIndices[EntryIndex] = UnorderedClipIndices[Order[EntryIndex]];
+		ClipTimes[EntryIndex] = UnorderedClipTimes[Order[EntryIndex]];
+	}
+}
+#endif // WITH_EDITOR
+
+bool FLocomotionFeatureDatabase::FindNearest(const FLocomotionFeatureQuery& Query, int32& OutClipIndex, float& OutClipTime, int32* OutComparisons) const
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	float QueryFeatures[NumDimensions];
+	WriteFeatures(Query, QueryFeatures);
+
+	const ParagonCore::FNearestFeature Nearest = ParagonCore::FindNearestFeature(Features.GetData(), SplitDimensions.GetData(), Num(), NumDimensions, QueryFeatures);
+	if (OutComparisons)
+	{
+		*OutComparisons = Nearest.NumComparisons;
+	}
+	if (Nearest.Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutClipIndex = ClipIndices[Nearest.Index];
+	OutClipTime = ClipTimes[Nearest.Index];
+	return true;
+}
+
+SIZE_T FLocomotionFeatureDatabase::GetTotalSize() const
+{
+	return sizeof(FLocomotionFeatureDatabase) + Features.GetAllocatedSize() + SplitDimensions.GetAllocatedSize() + ClipIndices.GetAllocatedSize() + ClipTimes.GetAllocatedSize();
+}
@@ -0,0 +1,219 @@
+#include "ParagonAnimBudgetSubsystem.h"
+#include "ParagonAnimInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "ParagonAnimationStats.h"
+
+namespace
+{
+	float AnimBudgetMs = 1.f;
+	int32 AnimBudgetMaxTickRate = 4;
+	float AnimBudgetInitialEstimateMs = 0.05f;
+	float AnimBudgetOffscreenSignificance = 0.25f;
+
+	FAutoConsoleVariableRef CVarAnimBudgetMs(
+		TEXT("Paragon.AnimBudget.BudgetMs"),
+		AnimBudgetMs,
+		TEXT("Milliseconds per frame the Paragon characters on the animation budget may spend on updates, each character's cost divided by its tick rate.\n")
+		TEXT("Only exceeded when every character already runs at Paragon.AnimBudget.MaxTickRate."));
+
+	FAutoConsoleVariableRef CVarAnimBudgetMaxTickRate(
+		TEXT("Paragon.AnimBudget.MaxTickRate"),
+		AnimBudgetMaxTickRate,
+		TEXT("Lowest rate the least significant characters are updated at, in frames per update."));
+
+	FAutoConsoleVariableRef CVarAnimBudgetInitialEstimate(
+		TEXT("Paragon.AnimBudget.InitialEstimateMs"),
+		AnimBudgetInitialEstimateMs,
+		TEXT("Assumed update and evaluation cost of a character until its cost has been measured."));
+
+	FAutoConsoleVariableRef CVarAnimBudgetOffscreenSignificance(
+		TEXT("Paragon.AnimBudget.OffscreenSignificance"),
+		AnimBudgetOffscreenSignificance,
+		TEXT("Significance of characters that were not rendered recently, relative to visible ones at the same distance."));
+
+	/** Distance at which a visible character is half as significant as one right at the view */
+	const float SignificanceDistance = 1000.f;
+
+	/** Weight of the newest measurement in the cost average */
+	const float CostSmoothing = 0.1f;
+}
+
+void UParagonAnimBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UParagonAnimBudgetSubsystem::OnWorldPreActorTick);
+}
+
+void UParagonAnimBudgetSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	for (int32 Index = Entries.Num() - 1; Index >= 0; Index--)
+	{
+		Unregister(Entries[Index].AnimInstance.Get());
+	}
+	Entries.Reset();
+
+	Super::Deinitialize();
+}
+
+void UParagonAnimBudgetSubsystem::Register(UParagonAnimInstance* AnimInstance)
+{
+	USkeletalMeshComponent* Mesh = AnimInstance ? AnimInstance->GetSkelMeshComponent() : nullptr;
+	if (!Mesh || Entries.ContainsByPredicate([AnimInstance](const FEntry& Entry) { return Entry.AnimInstance == AnimInstance; }))
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.AnimInstance = AnimInstance;
+	Entry.CostMs = AnimBudgetInitialEstimateMs;
+	Entry.bPreviousUpdateRateOptimizations = Mesh->bEnableUpdateRateOptimizations;
+
+	// The external tick rate replaces the rate the update rate optimizations would pick themselves
+	Mesh->bEnableUpdateRateOptimizations = true;
+	Mesh->EnableExternalTickRateControl(true);
+	Mesh->EnableExternalInterpolation(true);
+	Mesh->SetExternalTickRate(1);
+}
+
+void UParagonAnimBudgetSubsystem::Unregister(UParagonAnimInstance* AnimInstance)
+{
+	const int32 Index = Entries.IndexOfByPredicate([AnimInstance](const FEntry& Entry) { return Entry.AnimInstance == AnimInstance; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (USkeletalMeshComponent* Mesh = AnimInstance ? AnimInstance->GetSkelMeshComponent() : nullptr)
+	{
+		Mesh->SetExternalTickRate(1);
+		Mesh->EnableExternalTickRateControl(false);
+		Mesh->EnableExternalInterpolation(false);
+		Mesh->bEnableUpdateRateOptimizations = Entries[Index].bPreviousUpdateRateOptimizations;
+	}
+
+	Entries.RemoveAtSwap(Index, 1, false);
+}
+
+float UParagonAnimBudgetSubsystem::CalculateSignificance(const UParagonAnimInstance& AnimInstance, const TArray<FVector, TInlineAllocator<4>>& ViewLocations) const
+{
+	const USkeletalMeshComponent* Mesh = AnimInstance.GetSkelMeshComponent();
+	const APawn* Pawn = AnimInstance.TryGetPawnOwner();
+
+	// The player's own character always comes first
+	if (Pawn && Pawn->IsLocallyControlled())
+	{
+		return MAX_flt;
+	}
+
+	float DistanceSquared = 0.f;
+	if (ViewLocations.Num() > 0)
+	{
+		DistanceSquared = MAX_flt;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(ViewLocation, Mesh->GetComponentLocation()));
+		}
+	}
+
+	float Significance = SignificanceDistance / (SignificanceDistance + FMath::Sqrt(DistanceSquared));
+	if (!Mesh->WasRecentlyRendered(0.2f))
+	{
+		Significance *= AnimBudgetOffscreenSignificance;
+	}
+
+	return Significance + AnimInstance.SignificanceBias;
+}
+
+void UParagonAnimBudgetSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld() || Entries.Num() == 0)
+	{
+		return;
+	}
+
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonAnimBudget);
+
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = InWorld->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+			ViewLocations.Add(Location);
+		}
+	}
+
+	// Drop instances destroyed without unregistering, and pick up what the last updates cost
+	for (int32 Index = Entries.Num() - 1; Index >= 0; Index--)
+	{
+		FEntry& Entry = Entries[Index];
+		UParagonAnimInstance* AnimInstance = Entry.AnimInstance.Get();
+		if (!AnimInstance || !AnimInstance->GetSkelMeshComponent())
+		{
+			Entries.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		const uint32 AnimationCycles = AnimInstance->GetParagonProxyOnGameThread().ConsumeAnimationCycles();
+		if (AnimationCycles > 0)
+		{
+			Entry.CostMs = FMath::Lerp(Entry.CostMs, (float)FPlatformTime::ToMilliseconds(AnimationCycles), CostSmoothing);
+		}
+
+		Entry.Significance = CalculateSignificance(*AnimInstance, ViewLocations);
+	}
+
+	Entries.Sort([](const FEntry& A, const FEntry& B) { return A.Significance > B.Significance; });
+
+	// Every character gets the lowest rate that still leaves the characters after it enough of the budget to run at
+	// MaxTickRate, so the more significant a character the more often it updates and the costs over the rates fit the budget
+	const float BudgetMs = FMath::Max(AnimBudgetMs, KINDA_SMALL_NUMBER);
+	const int32 MaxTickRate = FMath::Clamp(AnimBudgetMaxTickRate, 1, 255);
+
+	FParagonAnimBudgetTelemetry FrameTelemetry;
+	FrameTelemetry.BudgetMs = AnimBudgetMs;
+
+	float RemainingCostMs = 0.f;
+	for (const FEntry& Entry : Entries)
+	{
+		RemainingCostMs += Entry.CostMs;
+	}
+
+	int32 TickRate = 1;
+	for (const FEntry& Entry : Entries)
+	{
+		RemainingCostMs -= Entry.CostMs;
+		const float AvailableMs = BudgetMs - FrameTelemetry.UsedMs - RemainingCostMs / MaxTickRate;
+		const int32 FittingTickRate = AvailableMs > 0.f ? FMath::CeilToInt(FMath::Min(Entry.CostMs / AvailableMs, (float)MaxTickRate)) : MaxTickRate;
+		TickRate = FMath::Clamp(FittingTickRate, TickRate, MaxTickRate);
+
+		Entry.AnimInstance->GetSkelMeshComponent()->SetExternalTickRate((uint8)TickRate);
+
+		FrameTelemetry.UsedMs += Entry.CostMs / TickRate;
+		if (TickRate > 1)
+		{
+			FrameTelemetry.NumDeferred++;
+		}
+		else
+		{
+			FrameTelemetry.NumFullRate++;
+		}
+	}
+
+	FrameTelemetry.OverflowMs = FMath::Max(FrameTelemetry.UsedMs - AnimBudgetMs, 0.f);
+
+	Telemetry = FrameTelemetry;
+	SET_FLOAT_STAT(STAT_ParagonAnimBudgetUsedMs, Telemetry.UsedMs);
+	SET_FLOAT_STAT(STAT_ParagonAnimBudgetOverflowMs, Telemetry.OverflowMs);
+	SET_DWORD_STAT(STAT_ParagonAnimBudgetFullRate, Telemetry.NumFullRate);
+	SET_DWORD_STAT(STAT_ParagonAnimBudgetDeferred, Telemetry.NumDeferred);
+}
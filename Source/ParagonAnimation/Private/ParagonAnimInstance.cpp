@@ -1,118 +1,188 @@
 #include "ParagonAnimInstance.h"
 #include "DrawDebugHelpers.h"
 #include "GameFramework/Character.h"
-#include "GameFramework/CharacterMovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "ParagonLocomotionSubsystem.h"
+#include "ParagonAnimStreamingSubsystem.h"
+#include "ParagonAnimBudgetSubsystem.h"
+#include "ParagonLocomotionClipSet.h"
+#include "ParagonAnimationBenchmark.h"
+#include "ParagonAnimationStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "UObject/UObjectIterator.h"
+
+FParagonAnimInstanceProxy::FParagonAnimInstanceProxy()
+	: bDrawDebug(false)
+	, bRotateRootBone(false)
+	, bBatched(false)
+	, PendingTurnYaw(0.f)
+	, bTurnedThisUpdate(false)
+	, AnimationCycles(0)
+{
+}
 
-#pragma optimize( "", off )
-namespace
+FParagonAnimInstanceProxy::FParagonAnimInstanceProxy(UAnimInstance* InAnimInstance)
+	: FAnimInstanceProxy(InAnimInstance)
+	, bDrawDebug(false)
+	, bRotateRootBone(false)
+	, bBatched(false)
+	, PendingTurnYaw(0.f)
+	, bTurnedThisUpdate(false)
+	, AnimationCycles(0)
+{
+}
+
+FParagonAnimInstanceProxy* FParagonAnimInstanceProxy::FromProxy(FAnimInstanceProxy* Proxy)
 {
-	// Copy from CharacterMovementComponent
-	bool PredictStopLocation(
-		FVector& OutStopLocation,
-		const FVector& CurrentLocation,
-		const FVector& Velocity,
-		const FVector& Acceleration,
-		float Friction,
-		float BrakingDeceleration,
-		const float TimeStep,
-		const int MaxSimulationIterations /*= 10*/)
+	const UObject* AnimInstance = Proxy ? Proxy->GetAnimInstanceObject() : nullptr;
+	return AnimInstance && AnimInstance->IsA<UParagonAnimInstance>() ? static_cast<FParagonAnimInstanceProxy*>(Proxy) : nullptr;
+}
+
+const FParagonAnimInstanceProxy* FParagonAnimInstanceProxy::FromProxy(const FAnimInstanceProxy* Proxy)
+{
+	return FromProxy(const_cast<FAnimInstanceProxy*>(Proxy));
+}
+
+void FParagonAnimInstanceProxy::InitializeLocomotion(UParagonAnimInstance* InAnimInstance)
+{
+	Input.Gather(Cast<ACharacter>(InAnimInstance->TryGetPawnOwner()));
+	if (Input.bIsValid)
 	{
-		const float MIN_TICK_TIME = 1e-6;
-		if (TimeStep < MIN_TICK_TIME)
-		{
-			return false;
-		}
-		// Apply braking or deceleration
-		const bool bZeroAcceleration = Acceleration.IsZero();
+		ParagonLocomotion::Initialize(State, Input);
+		FixedStep = FParagonLocomotionFixedStep();
+	}
+}
 
-		if ((Acceleration | Velocity) > 0.0f)
-		{
-			return false;
-		}
+void FParagonAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
 
-		BrakingDeceleration = FMath::Max(BrakingDeceleration, 0.f);
-		Friction = FMath::Max(Friction, 0.f);
-		const bool bZeroFriction = (Friction == 0.f);
-		const bool bZeroBraking = (BrakingDeceleration == 0.f);
+	PARAGON_BENCHMARK_SCOPE(InstanceUpdate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonInstanceUpdate);
 
-		if (bZeroAcceleration && bZeroFriction)
-		{
-			return false;
-		}
+	UParagonAnimInstance* ParagonAnimInstance = CastChecked<UParagonAnimInstance>(InAnimInstance);
 
-		FVector LastVelocity = bZeroAcceleration ? Velocity : Velocity.ProjectOnToNormal(Acceleration.GetSafeNormal());
-		LastVelocity.Z = 0;
+	bBatched = ParagonAnimInstance->bRegisteredForBatchedUpdate;
+	bTurnedThisUpdate = false;
+	bRotateRootBone = ParagonAnimInstance->bRotateRootBone;
+	Recorder = ParagonAnimInstance->Recorder;
+	if (bBatched)
+	{
+		return;
+	}
 
-		FVector LastLocation = CurrentLocation;
+	Input.Gather(Cast<ACharacter>(ParagonAnimInstance->TryGetPawnOwner()));
 
-		int Iterations = 0;
-		while (Iterations < MaxSimulationIterations)
-		{
-			Iterations++;
+	Settings = ParagonAnimInstance->GetLocomotionSettings();
+	bDrawDebug = ParagonAnimInstance->bDrawDebug;
+}
 
-			const FVector OldVel = LastVelocity;
+void FParagonAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	FAnimInstanceProxy::Update(DeltaSeconds);
 
-			// Only apply braking if there is no acceleration, or we are over our max speed and need to slow down to it.
-			if (bZeroAcceleration)
-			{
-				// subdivide braking to get reasonably consistent results at lower frame rates
-				// (important for packet loss situations w/ networking)
-				float RemainingTime = TimeStep;
-				const float MaxTimeStep = (1.0f / 33.0f);
-
-				// Decelerate to brake to a stop
-				const FVector RevAccel = (bZeroBraking ? FVector::ZeroVector : (-BrakingDeceleration * LastVelocity.GetSafeNormal()));
-				while (RemainingTime >= MIN_TICK_TIME)
-				{
-					// Zero friction uses constant deceleration, so no need for iteration.
-					const float dt = ((RemainingTime > MaxTimeStep && !bZeroFriction) ? FMath::Min(MaxTimeStep, RemainingTime * 0.5f) : RemainingTime);
-					RemainingTime -= dt;
-
-					// apply friction and braking
-					LastVelocity = LastVelocity + ((-Friction) * LastVelocity + RevAccel) * dt;
-
-					// Don't reverse direction
-					if ((LastVelocity | OldVel) <= 0.f)
-					{
-						LastVelocity = FVector::ZeroVector;
-						break;
-					}
-				}
-
-				// Clamp to zero if nearly zero, or if below min threshold and braking.
-				const float VSizeSq = LastVelocity.SizeSquared();
-				if (VSizeSq <= 1.f || (!bZeroBraking && VSizeSq <= FMath::Square(10)))
-				{
-					LastVelocity = FVector::ZeroVector;
-				}
-			}
-			else
-			{
-				FVector TotalAcceleration = Acceleration;
-				TotalAcceleration.Z = 0;
-
-				// Friction affects our ability to change direction. This is only done for input acceleration, not path following.
-				const FVector AccelDir = TotalAcceleration.GetSafeNormal();
-				const float VelSize = LastVelocity.Size();
-				TotalAcceleration += -(LastVelocity - AccelDir * VelSize) * Friction;
-				// Apply acceleration
-				LastVelocity += TotalAcceleration * TimeStep;
-			}
+	const uint32 StartCycles = FPlatformTime::Cycles();
+	ON_SCOPE_EXIT { AnimationCycles += FPlatformTime::Cycles() - StartCycles; };
 
-			LastLocation += LastVelocity * TimeStep;
+	PARAGON_BENCHMARK_SCOPE(InstanceUpdate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonInstanceUpdate);
 
-			// Clamp to zero if nearly zero, or if below min threshold and braking.
-			const float VSizeSq = LastVelocity.SizeSquared();
-			if (VSizeSq <= 1.f
-				|| (LastVelocity | OldVel) <= 0.f)
-			{
-				OutStopLocation = LastLocation;
-				return true;
-			}
+	if (bBatched)
+	{
+		CastChecked<UParagonAnimInstance>(GetAnimInstanceObject())->ApplyLocomotionState(State);
+		return;
+	}
+
+	if (Recorder.IsValid())
+	{
+		Recorder->Record(DeltaSeconds, Input, Settings);
+	}
+
+	if (!Input.bIsValid)
+	{
+		State.bStartedThisUpdate = false;
+		State.bStoppedThisUpdate = false;
+		return;
+	}
+
+	ParagonLocomotion::UpdateFixedStep(State, FixedStep, Settings, Input, DeltaSeconds);
+
+	// The game thread does not touch the instance while the parallel update runs,
+	// writing here lets the anim graph that is updated next read this frame's values
+	CastChecked<UParagonAnimInstance>(GetAnimInstanceObject())->ApplyLocomotionState(State);
+}
+
+void FParagonAnimInstanceProxy::UpdateAnimationNode(const FAnimationUpdateContext& InContext)
+{
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	FAnimInstanceProxy::UpdateAnimationNode(InContext);
+
+	AnimationCycles += FPlatformTime::Cycles() - StartCycles;
+}
+
+void FParagonAnimInstanceProxy::EvaluateAnimationNode(FPoseContext& Output)
+{
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	FAnimInstanceProxy::EvaluateAnimationNode(Output);
+
+	AnimationCycles += FPlatformTime::Cycles() - StartCycles;
+}
+
+void FParagonAnimInstanceProxy::ConsumeTurnYaw(float TurnedYaw)
+{
+	if (TurnedYaw == 0.f || !Input.bIsValid)
+	{
+		return;
+	}
+
+	ParagonLocomotion::ConsumeTurnYaw(State, FixedStep, Input, TurnedYaw);
+	bTurnedThisUpdate = true;
+
+	// The batched state is replaced on the next gather, the subsystem turns the batch slot as well
+	if (bBatched)
+	{
+		PendingTurnYaw += TurnedYaw;
+	}
+
+	// Nodes updated after the turn, like Root Yaw Offset, see the mesh where it is now
+	CastChecked<UParagonAnimInstance>(GetAnimInstanceObject())->ApplyLocomotionState(State);
+}
+
+void FParagonAnimInstanceProxy::PostUpdate(UAnimInstance* InAnimInstance) const
+{
+	FAnimInstanceProxy::PostUpdate(InAnimInstance);
+
+	PARAGON_BENCHMARK_SCOPE(InstanceUpdate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonInstanceUpdate);
+
+	// The subsystem already rotated the mesh
+	if (bBatched || !Input.bIsValid)
+	{
+		return;
+	}
+
+	if ((State.IsAccelerating || bTurnedThisUpdate) && !bRotateRootBone)
+	{
+		if (USkeletalMeshComponent* Mesh = InAnimInstance->GetSkelMeshComponent())
+		{
+			// ǵùرƶNetworkSmoothingMeshRotation޸ĻᱻSmoothClientPosition
+			Mesh->SetWorldRotation(State.MeshRotation);
 		}
+	}
 
-		return false;
+#if ENABLE_DRAW_DEBUG
+	if (bDrawDebug)
+	{
+		if (State.bStartedThisUpdate)
+			DrawDebugSphere(InAnimInstance->GetWorld(), State.DistanceMachingStartLocation, 10, 8, FColor::Green, false, 3.f);
+		else if (State.bStoppedThisUpdate)
+			DrawDebugSphere(InAnimInstance->GetWorld(), State.DistanceMachingStopLocation, 10, 8, FColor::Red, false, 3.f);
 	}
+#endif // ENABLE_DRAW_DEBUG
 }
 
 UParagonAnimInstance::UParagonAnimInstance(const FObjectInitializer& ObjectInitializer)
@@ -130,149 +200,197 @@ UParagonAnimInstance::UParagonAnimInstance(const FObjectInitializer& ObjectIniti
 	DistanceMachingStart = 0.f;
 	DistanceMachingStop = 0.f;
 	DistanceMachingScaling = 1.f;
-
-	ActorRotation = FRotator::ZeroRotator;
-	MeshRotation = FRotator::ZeroRotator;
-	DistanceMachingStartLocation = FVector::ZeroVector;
-	DistanceMachingStopLocation = FVector::ZeroVector;
+	RootYawOffset = 0.f;
+	RemainingTurnYaw = 0.f;
+	bRotateRootBone = false;
 
 	bDrawDebug = false;
+	bUseBatchedUpdate = false;
+	StopPredictionMaxLOD = 1;
+	FixedUpdateRate = 0.f;
+	FixedUpdateMinLOD = 1;
+	bRegisteredForBatchedUpdate = false;
+	bUseAnimationBudget = false;
+	SignificanceBias = 0.f;
+	bRegisteredForBudget = false;
+	ClipSet = nullptr;
+	AcquiredClipSet = nullptr;
 }
 
 void UParagonAnimInstance::NativeBeginPlay()
 {
 	Super::NativeBeginPlay();
 
-	ACharacter* Character = Cast<ACharacter>(TryGetPawnOwner());
-	if (Character)
+	GetParagonProxyOnGameThread().InitializeLocomotion(this);
+
+	if (bUseAnimationBudget)
 	{
-		ActorRotation = Character->GetActorRotation();
-		MeshRotation = Character->GetBaseRotationOffsetRotator() + ActorRotation;
+		if (UParagonAnimBudgetSubsystem* BudgetSubsystem = UWorld::GetSubsystem<UParagonAnimBudgetSubsystem>(GetWorld()))
+		{
+			BudgetSubsystem->Register(this);
+			bRegisteredForBudget = true;
+		}
 	}
-}
-
-void UParagonAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
-{
-	Super::NativeUpdateAnimation(DeltaSeconds);
-
-	ACharacter* Character = Cast<ACharacter>(TryGetPawnOwner());
-	if (!Character)
-		return;
-
-	UCharacterMovementComponent* CharacterMovement = Character->GetCharacterMovement();
-	if (!ensure(CharacterMovement))
-		return;
 
-	USkeletalMeshComponent* Mesh = Character->GetMesh();
-	if (!ensure(Mesh))
-		return;
+	if (ClipSet)
+	{
+		if (UParagonAnimStreamingSubsystem* Streaming = UWorld::GetSubsystem<UParagonAnimStreamingSubsystem>(GetWorld()))
+		{
+			Streaming->AcquireClipSet(ClipSet);
+			AcquiredClipSet = ClipSet;
+		}
+	}
 
-	const FVector CurrentActorLoaction = Character->GetActorLocation();
-	const FVector CurrentAcceleration = CharacterMovement->GetCurrentAcceleration();
-	const FVector CurrentVelocity = CharacterMovement->Velocity;
-	const FRotator NewActorRotation = Character->GetActorRotation();
-	const FRotator BaseMeshRotationOffset = Character->GetBaseRotationOffsetRotator();
+	if (bUseBatchedUpdate)
+	{
+		if (UParagonLocomotionSubsystem* LocomotionSubsystem = UWorld::GetSubsystem<UParagonLocomotionSubsystem>(GetWorld()))
+		{
+			LocomotionSubsystem->Register(this);
+			bRegisteredForBatchedUpdate = true;
+		}
+	}
+}
 
-	const bool IsAcceleratingNow = !CurrentAcceleration.IsNearlyZero();
+void UParagonAnimInstance::NativeUninitializeAnimation()
+{
+	StopRecording();
 
-	if (IsAcceleratingNow != IsAccelerating)
+	if (bRegisteredForBatchedUpdate)
 	{
-		if (IsAcceleratingNow)
+		if (UParagonLocomotionSubsystem* LocomotionSubsystem = UWorld::GetSubsystem<UParagonLocomotionSubsystem>(GetWorld()))
 		{
-			DistanceMachingStartLocation = CurrentActorLoaction;
+			LocomotionSubsystem->Unregister(this);
 		}
-		else
+		bRegisteredForBatchedUpdate = false;
+	}
+
+	if (bRegisteredForBudget)
+	{
+		if (UParagonAnimBudgetSubsystem* BudgetSubsystem = UWorld::GetSubsystem<UParagonAnimBudgetSubsystem>(GetWorld()))
 		{
-			PredictStopLocation(
-				DistanceMachingStopLocation,
-				CurrentActorLoaction,
-				CurrentVelocity,
-				CurrentAcceleration,
-				CharacterMovement->BrakingFriction * CharacterMovement->BrakingFrictionFactor,
-				CharacterMovement->GetMaxBrakingDeceleration(),
-				CharacterMovement->MaxSimulationTimeStep,
-				100);
+			BudgetSubsystem->Unregister(this);
 		}
+		bRegisteredForBudget = false;
+	}
 
-#if ENABLE_DRAW_DEBUG
-		if (bDrawDebug)
+	if (AcquiredClipSet)
+	{
+		if (UParagonAnimStreamingSubsystem* Streaming = UWorld::GetSubsystem<UParagonAnimStreamingSubsystem>(GetWorld()))
 		{
-			if (IsAcceleratingNow)
-				DrawDebugSphere(GetWorld(), DistanceMachingStartLocation, 10, 8, FColor::Green, false, 3.f);
-			else
-				DrawDebugSphere(GetWorld(), DistanceMachingStopLocation, 10, 8, FColor::Red, false, 3.f);
+			Streaming->ReleaseClipSet(AcquiredClipSet);
 		}
-#endif // ENABLE_DRAW_DEBUG
+		AcquiredClipSet = nullptr;
 	}
 
-	DistanceMachingStart = FVector::Dist2D(CurrentActorLoaction, DistanceMachingStartLocation) * DistanceMachingScaling;
-	DistanceMachingStop = -FVector::Dist2D(CurrentActorLoaction, DistanceMachingStopLocation) * DistanceMachingScaling;
-
-	IsAccelerating = IsAcceleratingNow;
-	IsMoving = !CurrentVelocity.IsNearlyZero();
+	Super::NativeUninitializeAnimation();
+}
 
-	float YawDelta = FMath::FindDeltaAngleDegrees(ActorRotation.Yaw, NewActorRotation.Yaw);
-	Lean = FMath::FInterpTo(Lean, YawDelta / DeltaSeconds * LeanFactor, DeltaSeconds, LeanInterpSpeed);
+FParagonLocomotionSettings UParagonAnimInstance::GetLocomotionSettings() const
+{
+	FParagonLocomotionSettings Settings;
+	Settings.LeanFactor = LeanFactor;
+	Settings.LeanInterpSpeed = LeanInterpSpeed;
+	Settings.MeshRotationInterpSpeed = MeshRotationInterpSpeed;
+	Settings.DistanceMachingScaling = DistanceMachingScaling;
+
+	const USkeletalMeshComponent* Mesh = GetSkelMeshComponent();
+	Settings.bPredictStop = StopPredictionMaxLOD < 0 || !Mesh || Mesh->GetPredictedLODLevel() <= StopPredictionMaxLOD;
+	Settings.FixedUpdateRate = (Mesh && Mesh->GetPredictedLODLevel() >= FixedUpdateMinLOD) ? FixedUpdateRate : 0.f;
+	return Settings;
+}
 
-	ActorRotation = NewActorRotation;
+bool UParagonAnimInstance::StartRecording(const FString& Filename)
+{
+	if (bRegisteredForBatchedUpdate)
+	{
+		UE_LOG(LogAnimation, Warning, TEXT("%s uses the batched update, its inputs cannot be recorded"), *GetPathName());
+		return false;
+	}
 
-	if (IsAccelerating)
+	// The proxy may still be writing the previous recording on a worker thread, it lets go on the next update
+	TSharedPtr<FParagonLocomotionRecorder, ESPMode::ThreadSafe> NewRecorder = MakeShared<FParagonLocomotionRecorder, ESPMode::ThreadSafe>();
+	const FParagonAnimInstanceProxy& Proxy = GetParagonProxyOnGameThread();
+	if (!NewRecorder->Open(Filename, Proxy.GetLocomotionState(), Proxy.GetLocomotionFixedStep()))
 	{
-		float CardinalDirectionAngle = 0.f;
+		UE_LOG(LogAnimation, Warning, TEXT("Could not open %s to record %s"), *Filename, *GetPathName());
+		return false;
+	}
 
-		const FRotator InputRotation = CurrentAcceleration.ToOrientationRotator();
+	Recorder = NewRecorder;
+	return true;
+}
 
-		const float InputDelta = FMath::FindDeltaAngleDegrees(InputRotation.Yaw, ActorRotation.Yaw);
-		if (InputDelta > 0.f)
+void UParagonAnimInstance::StopRecording()
+{
+	Recorder.Reset();
+}
+
+FAnimInstanceProxy* UParagonAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FParagonAnimInstanceProxy(this);
+}
+
+void UParagonAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+	delete InProxy;
+}
+
+void UParagonAnimInstance::ApplyLocomotionState(const FParagonLocomotionState& State)
+{
+	IsAccelerating = State.IsAccelerating;
+	IsMoving = State.IsMoving;
+	Lean = State.Lean;
+	CardinalDirection = State.CardinalDirection;
+	AimYaw = State.AimYaw;
+	AimPitch = State.AimPitch;
+	DistanceMachingStart = State.DistanceMachingStart;
+	DistanceMachingStop = State.DistanceMachingStop;
+	RootYawOffset = State.RootYawOffset;
+	RemainingTurnYaw = -State.RootYawOffset;
+}
+
+namespace
+{
+	/** Toggle recording of every Paragon anim instance in game worlds, one file per instance */
+	void ToggleLocomotionRecording(const TArray<FString>& Args)
+	{
+		const FString Directory = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("Locomotion");
+		const FString Timestamp = FDateTime::Now().ToString();
+
+		bool bAnyRecording = false;
+		for (TObjectIterator<UParagonAnimInstance> It; It; ++It)
 		{
-			if (InputDelta < 70.f)
-			{
-				CardinalDirection = EAnimCardinalDirection::North;
-				CardinalDirectionAngle = InputDelta;
-			}
-			else if (InputDelta > 110.f)
-			{
-				CardinalDirection = EAnimCardinalDirection::South;
-				CardinalDirectionAngle = InputDelta + 180;
-			}
-			else
-			{
-				CardinalDirection = EAnimCardinalDirection::West;
-				CardinalDirectionAngle = InputDelta - 90;
-			}
+			bAnyRecording |= It->IsRecording();
 		}
-		else
+
+		int32 NumInstances = 0;
+		for (TObjectIterator<UParagonAnimInstance> It; It; ++It)
 		{
-			if (InputDelta > -70.f)
+			UParagonAnimInstance* AnimInstance = *It;
+			const UWorld* World = AnimInstance->GetWorld();
+			if (!World || !World->IsGameWorld())
 			{
-				CardinalDirection = EAnimCardinalDirection::North;
-				CardinalDirectionAngle = InputDelta;
+				continue;
 			}
-			else if (InputDelta < -110.f)
+
+			if (bAnyRecording)
 			{
-				CardinalDirection = EAnimCardinalDirection::South;
-				CardinalDirectionAngle = InputDelta + 180;
+				NumInstances += AnimInstance->IsRecording() ? 1 : 0;
+				AnimInstance->StopRecording();
 			}
 			else
 			{
-				CardinalDirection = EAnimCardinalDirection::East;
-				CardinalDirectionAngle = InputDelta + 90;
+				const FString Filename = Directory / FString::Printf(TEXT("%s_%s_%d%s"), *GetNameSafe(AnimInstance->GetOwningActor()), *Timestamp, NumInstances, ParagonLocomotionRecording::FileExtension);
+				NumInstances += AnimInstance->StartRecording(Filename) ? 1 : 0;
 			}
 		}
 
-		CardinalDirectionAngle = -CardinalDirectionAngle;
-
-		const FRotator CardinalDirectionRotation(0.f, CardinalDirectionAngle, 0.f);
-		const FRotator TargetMeshRotation = BaseMeshRotationOffset + CardinalDirectionRotation + ActorRotation;
-		MeshRotation = FMath::RInterpTo(MeshRotation, TargetMeshRotation, DeltaSeconds, MeshRotationInterpSpeed);
-		// ǵùرƶNetworkSmoothingMeshRotation޸ĻᱻSmoothClientPosition
-		Mesh->SetWorldRotation(MeshRotation);
+		UE_LOG(LogAnimation, Display, TEXT("%s recording %d Paragon anim instances%s%s"), bAnyRecording ? TEXT("Stopped") : TEXT("Started"), NumInstances,
+			bAnyRecording ? TEXT("") : TEXT(" to "), bAnyRecording ? TEXT("") : *Directory);
 	}
 
-	const FRotator BaseAimRotation = Character->GetBaseAimRotation();
-	FRotator AimDelta = BaseAimRotation - (MeshRotation - BaseMeshRotationOffset);
-	AimDelta.Normalize();
-	AimYaw = AimDelta.Yaw;
-	AimPitch = AimDelta.Pitch;
+	FAutoConsoleCommand ToggleLocomotionRecordingCommand(
+		TEXT("Paragon.RecordLocomotion"),
+		TEXT("Start or stop recording the locomotion inputs of every Paragon anim instance. Args: [Directory]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&ToggleLocomotionRecording));
 }
-#pragma optimize( "", on )
@@ -0,0 +1,180 @@
+#include "ParagonAnimStreamingSubsystem.h"
+#include "ParagonLocomotionClipSet.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "ParagonAnimationStats.h"
+
+namespace
+{
+	float StreamingBudgetMB = 64.f;
+
+	FAutoConsoleVariableRef CVarAnimStreamingBudget(
+		TEXT("Paragon.AnimStreaming.BudgetMB"),
+		StreamingBudgetMB,
+		TEXT("Memory the streamed locomotion clips may keep resident, unreferenced clips above it are released least recently used first."));
+}
+
+void UParagonAnimStreamingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	NumResident = 0;
+	ResidentBytes = 0;
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UParagonAnimStreamingSubsystem::OnWorldPostActorTick);
+}
+
+void UParagonAnimStreamingSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	for (TPair<FSoftObjectPath, FEntry>& Pair : Entries)
+	{
+		if (Pair.Value.Handle.IsValid())
+		{
+			Pair.Value.Handle->CancelHandle();
+		}
+	}
+	Entries.Reset();
+	NumResident = 0;
+	ResidentBytes = 0;
+	SET_MEMORY_STAT(STAT_ParagonStreamedSequenceMemory, 0);
+
+	Super::Deinitialize();
+}
+
+void UParagonAnimStreamingSubsystem::AcquireClipSet(const UParagonLocomotionClipSet* ClipSet)
+{
+	if (!ClipSet)
+	{
+		return;
+	}
+
+	for (const TSoftObjectPtr<UAnimSequenceBase>& Sequence : ClipSet->Sequences)
+	{
+		if (!Sequence.IsNull())
+		{
+			FindOrLoad(Sequence.ToSoftObjectPath()).RefCount++;
+		}
+	}
+}
+
+void UParagonAnimStreamingSubsystem::ReleaseClipSet(const UParagonLocomotionClipSet* ClipSet)
+{
+	if (!ClipSet)
+	{
+		return;
+	}
+
+	for (const TSoftObjectPtr<UAnimSequenceBase>& Sequence : ClipSet->Sequences)
+	{
+		if (FEntry* Entry = Entries.Find(Sequence.ToSoftObjectPath()))
+		{
+			// Stays resident until the budget needs the memory, a hero of the same kind often respawns shortly after
+			Entry->RefCount = FMath::Max(Entry->RefCount - 1, 0);
+		}
+	}
+}
+
+UAnimSequenceBase* UParagonAnimStreamingSubsystem::RequestSequence(const TSoftObjectPtr<UAnimSequenceBase>& Sequence)
+{
+	if (Sequence.IsNull())
+	{
+		return nullptr;
+	}
+
+	FEntry& Entry = FindOrLoad(Sequence.ToSoftObjectPath());
+	Entry.LastUsedFrame = GFrameCounter;
+	return Entry.bResident ? Sequence.Get() : nullptr;
+}
+
+UParagonAnimStreamingSubsystem::FEntry& UParagonAnimStreamingSubsystem::FindOrLoad(const FSoftObjectPath& Path)
+{
+	if (FEntry* Entry = Entries.Find(Path))
+	{
+		return *Entry;
+	}
+
+	FEntry& Entry = Entries.Add(Path);
+	Entry.LastUsedFrame = GFrameCounter;
+	Entry.Handle = StreamableManager.RequestAsyncLoad(Path, FStreamableDelegate::CreateUObject(this, &UParagonAnimStreamingSubsystem::OnLoaded, Path));
+
+	// Already loaded clips complete without calling back
+	if (Entry.Handle.IsValid() && Entry.Handle->HasLoadCompleted() && !Entry.bResident)
+	{
+		OnLoaded(Path);
+	}
+	return Entries.FindChecked(Path);
+}
+
+void UParagonAnimStreamingSubsystem::OnLoaded(FSoftObjectPath Path)
+{
+	FEntry* Entry = Entries.Find(Path);
+	if (!Entry || Entry->bResident)
+	{
+		return;
+	}
+
+	UAnimSequenceBase* Sequence = Cast<UAnimSequenceBase>(Path.ResolveObject());
+	if (!Sequence)
+	{
+		UE_LOG(LogAnimation, Warning, TEXT("Could not stream in locomotion clip %s"), *Path.ToString());
+		return;
+	}
+
+	Entry->bResident = true;
+	Entry->SizeBytes = Sequence->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	NumResident++;
+	ResidentBytes += Entry->SizeBytes;
+	SET_MEMORY_STAT(STAT_ParagonStreamedSequenceMemory, ResidentBytes);
+}
+
+void UParagonAnimStreamingSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	const int64 BudgetBytes = (int64)(StreamingBudgetMB * 1024.f * 1024.f);
+	if (ResidentBytes > BudgetBytes)
+	{
+		Evict(BudgetBytes);
+	}
+}
+
+void UParagonAnimStreamingSubsystem::Evict(int64 BudgetBytes)
+{
+	TArray<FSoftObjectPath, TInlineAllocator<32>> Candidates;
+	for (const TPair<FSoftObjectPath, FEntry>& Pair : Entries)
+	{
+		// Clips a node played this frame are still referenced by the node and would not be collected anyway
+		if (Pair.Value.bResident && Pair.Value.RefCount == 0 && Pair.Value.LastUsedFrame != GFrameCounter)
+		{
+			Candidates.Add(Pair.Key);
+		}
+	}
+
+	Candidates.Sort([this](const FSoftObjectPath& A, const FSoftObjectPath& B)
+	{
+		return Entries.FindChecked(A).LastUsedFrame < Entries.FindChecked(B).LastUsedFrame;
+	});
+
+	for (const FSoftObjectPath& Path : Candidates)
+	{
+		if (ResidentBytes <= BudgetBytes)
+		{
+			break;
+		}
+
+		FEntry Entry;
+		Entries.RemoveAndCopyValue(Path, Entry);
+
+		// Without the handle the clip is collected once no node plays it anymore
+		Entry.Handle->ReleaseHandle();
+		NumResident--;
+		ResidentBytes -= Entry.SizeBytes;
+	}
+
+	SET_MEMORY_STAT(STAT_ParagonStreamedSequenceMemory, ResidentBytes);
+}
@@ -1,19 +1,82 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "ParagonAnimation.h"
+#include "DistanceCurveRegistry.h"
+#include "AimOffsetPoseCache.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Animation/Skeleton.h"
+#include "UObject/UObjectGlobals.h"
+#include "ParagonAnimationStats.h"
 
 #define LOCTEXT_NAMESPACE "FParagonAnimationModule"
 
+DEFINE_STAT(STAT_ParagonInstanceUpdate);
+DEFINE_STAT(STAT_ParagonBatchedUpdate);
+DEFINE_STAT(STAT_ParagonDistanceMatchingUpdate);
+DEFINE_STAT(STAT_ParagonDistanceMatchingEvaluate);
+DEFINE_STAT(STAT_ParagonAngleMatchingUpdate);
+DEFINE_STAT(STAT_ParagonAimOffsetEvaluate);
+DEFINE_STAT(STAT_ParagonCurveLookup);
+DEFINE_STAT(STAT_ParagonStopPrediction);
+DEFINE_STAT(STAT_ParagonAnimBudget);
+DEFINE_STAT(STAT_ParagonClipSelection);
+DEFINE_STAT(STAT_ParagonCurveLookups);
+DEFINE_STAT(STAT_ParagonStopPredictionIterations);
+DEFINE_STAT(STAT_ParagonPoseCacheHits);
+DEFINE_STAT(STAT_ParagonPoseCacheMisses);
+DEFINE_STAT(STAT_ParagonAnimBudgetFullRate);
+DEFINE_STAT(STAT_ParagonAnimBudgetDeferred);
+DEFINE_STAT(STAT_ParagonClipSelectionComparisons);
+DEFINE_STAT(STAT_ParagonAnimBudgetUsedMs);
+DEFINE_STAT(STAT_ParagonAnimBudgetOverflowMs);
+DEFINE_STAT(STAT_ParagonStreamedSequenceMemory);
+
+#if PARAGON_WITH_TRACE
+UE_TRACE_CHANNEL_DEFINE(ParagonAnimationChannel)
+#endif
+
 void FParagonAnimationModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FParagonAnimationModule::OnPostGarbageCollect);
+#if WITH_EDITOR
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FParagonAnimationModule::OnObjectPropertyChanged);
+#endif
 }
 
 void FParagonAnimationModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+#endif
+	FDistanceCurveRegistry::Get().Reset();
+	FAimOffsetPoseCache::Get().Reset();
+}
+
+void FParagonAnimationModule::OnPostGarbageCollect()
+{
+	FDistanceCurveRegistry::Get().RemoveStaleEntries();
+	FAimOffsetPoseCache::Get().RemoveStaleEntries();
+}
+
+#if WITH_EDITOR
+void FParagonAnimationModule::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// Curve edits and reimports both end in PostEditChange on the sequence
+	if (Object && Object->IsA<UAnimSequenceBase>())
+	{
+		FDistanceCurveRegistry::Get().Invalidate(Object);
+		FAimOffsetPoseCache::Get().Invalidate(Object);
+	}
+	else if (Object && Object->IsA<USkeleton>())
+	{
+		FAimOffsetPoseCache::Get().Invalidate(Object);
+	}
 }
+#endif
 
 #undef LOCTEXT_NAMESPACE
 	
@@ -0,0 +1,22 @@
+#include "ParagonAnimationBenchmark.h"
+
+#if PARAGON_WITH_BENCHMARK
+
+bool FParagonBenchmark::bEnabled = false;
+
+TAtomic<uint64> FParagonBenchmark::ScopeCycles[(int32)EParagonBenchmarkScope::Num];
+
+void FParagonBenchmark::Reset()
+{
+	for (TAtomic<uint64>& Cycles : ScopeCycles)
+	{
+		Cycles = 0;
+	}
+}
+
+double FParagonBenchmark::GetMilliseconds(EParagonBenchmarkScope Scope)
+{
+	return FPlatformTime::ToMilliseconds64(ScopeCycles[(int32)Scope].Load());
+}
+
+#endif // PARAGON_WITH_BENCHMARK
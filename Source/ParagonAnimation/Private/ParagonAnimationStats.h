@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_STATS_GROUP(TEXT("ParagonAnimation"), STATGROUP_ParagonAnimation, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Instance Update"), STAT_ParagonInstanceUpdate, STATGROUP_ParagonAnimation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batched Locomotion Update"), STAT_ParagonBatchedUpdate, STATGROUP_ParagonAnimation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Distance Matching Update"), STAT_ParagonDistanceMatchingUpdate, STATGROUP_ParagonAnimation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Distance Matching Evaluate"), STAT_ParagonDistanceMatchingEvaluate, STATGROUP_ParagonAnimation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Angle Matching Update"), STAT_ParagonAngleMatchingUpdate, STATGROUP_ParagonAnimation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Aim Offset Evaluate"), STAT_ParagonAimOffsetEvaluate, STATGROUP_ParagonAnimation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Curve Lookup"), STAT_ParagonCurveLookup, STATGROUP_ParagonAnimation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Stop Prediction"), STAT_ParagonStopPrediction, STATGROUP_ParagonAnimation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Animation Budget"), STAT_ParagonAnimBudget, STATGROUP_ParagonAnimation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Clip Selection"), STAT_ParagonClipSelection, STATGROUP_ParagonAnimation, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Curve Lookups"), STAT_ParagonCurveLookups, STATGROUP_ParagonAnimation, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Stop Prediction Iterations"), STAT_ParagonStopPredictionIterations, STATGROUP_ParagonAnimation, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pose Cache Hits"), STAT_ParagonPoseCacheHits, STATGROUP_ParagonAnimation, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pose Cache Misses"), STAT_ParagonPoseCacheMisses, STATGROUP_ParagonAnimation, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Budget Full Rate"), STAT_ParagonAnimBudgetFullRate, STATGROUP_ParagonAnimation, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Budget Deferred"), STAT_ParagonAnimBudgetDeferred, STATGROUP_ParagonAnimation, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Clip Selection Comparisons"), STAT_ParagonClipSelectionComparisons, STATGROUP_ParagonAnimation, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Budget Used (ms)"), STAT_ParagonAnimBudgetUsedMs, STATGROUP_ParagonAnimation, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Budget Overflow (ms)"), STAT_ParagonAnimBudgetOverflowMs, STATGROUP_ParagonAnimation, );
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Streamed Sequences"), STAT_ParagonStreamedSequenceMemory, STATGROUP_ParagonAnimation, );
+
+/** Insights events of the plugin are only recorded with -trace=cpu,ParagonAnimation */
+#define PARAGON_WITH_TRACE (CPUPROFILERTRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+#if PARAGON_WITH_TRACE
+UE_TRACE_CHANNEL_EXTERN(ParagonAnimationChannel)
+
+/** Cycle stat and Insights event of the same name, both compiled out of shipping builds */
+#define PARAGON_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, ParagonAnimationChannel)
+#else
+#define PARAGON_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#endif // PARAGON_WITH_TRACE
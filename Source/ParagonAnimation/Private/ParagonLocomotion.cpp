@@ -0,0 +1,346 @@
+#include "ParagonLocomotion.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "ParagonAnimationStats.h"
+#include "ParagonCore/StopPrediction.h"
+#include "ParagonCore/CardinalDirection.h"
+#include "ParagonCore/TurnInPlace.h"
+
+namespace
+{
+	FORCEINLINE ParagonCore::FVector3 ToCore(const FVector& V)
+	{
+		return ParagonCore::FVector3(V.X, V.Y, V.Z);
+	}
+
+	FORCEINLINE FVector ToEngine(const ParagonCore::FVector3& V)
+	{
+		return FVector(V.X, V.Y, V.Z);
+	}
+
+	static_assert((uint8)ParagonCore::ECardinalDirection::West == (uint8)EAnimCardinalDirection::West, "ParagonCore::ECardinalDirection must match EAnimCardinalDirection");
+}
+
+bool ParagonLocomotion::PredictStopLocation(
+	FVector& OutStopLocation,
+	const FVector& CurrentLocation,
+	const FVector& Velocity,
+	const FVector& Acceleration,
+	float Friction,
+	float BrakingDeceleration,
+	const float TimeStep,
+	const int MaxSimulationIterations /*= 10*/,
+	const bool bAllowClosedForm)
+{
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonStopPrediction);
+
+	ParagonCore::FVector3 StopLocation;
+	int Iterations = 0;
+	const bool bStops = ParagonCore::PredictStopLocation(StopLocation, ToCore(CurrentLocation), ToCore(Velocity), ToCore(Acceleration),
+		Friction, BrakingDeceleration, TimeStep, MaxSimulationIterations, bAllowClosedForm, &Iterations);
+	INC_DWORD_STAT_BY(STAT_ParagonStopPredictionIterations, Iterations);
+
+	if (bStops)
+	{
+		OutStopLocation = ToEngine(StopLocation);
+	}
+	return bStops;
+}
+
+void ParagonLocomotion::EstimateStopLocation(
+	FVector& OutStopLocation,
+	const FVector& CurrentLocation,
+	const FVector& Velocity,
+	float BrakingDeceleration)
+{
+	OutStopLocation = ToEngine(ParagonCore::EstimateStopLocation(ToCore(CurrentLocation), ToCore(Velocity), BrakingDeceleration));
+}
+
+FParagonLocomotionInput::FParagonLocomotionInput()
+	: ActorLocation(FVector::ZeroVector)
+	, Acceleration(FVector::ZeroVector)
+	, Velocity(FVector::ZeroVector)
+	, ActorRotation(FRotator::ZeroRotator)
+	, BaseRotationOffset(FRotator::ZeroRotator)
+	, BaseAimRotation(FRotator::ZeroRotator)
+	, BrakingFriction(0.f)
+	, BrakingDeceleration(0.f)
+	, MaxSimulationTimeStep(0.05f)
+	, bIsValid(false)
+{
+}
+
+void FParagonLocomotionInput::Gather(const ACharacter* Character)
+{
+	bIsValid = false;
+
+	if (!Character)
+		return;
+
+	const UCharacterMovementComponent* CharacterMovement = Character->GetCharacterMovement();
+	if (!ensure(CharacterMovement))
+		return;
+
+	if (!ensure(Character->GetMesh()))
+		return;
+
+	ActorLocation = Character->GetActorLocation();
+	Acceleration = CharacterMovement->GetCurrentAcceleration();
+	Velocity = CharacterMovement->Velocity;
+	ActorRotation = Character->GetActorRotation();
+	BaseRotationOffset = Character->GetBaseRotationOffsetRotator();
+	BaseAimRotation = Character->GetBaseAimRotation();
+	BrakingFriction = CharacterMovement->BrakingFriction * CharacterMovement->BrakingFrictionFactor;
+	BrakingDeceleration = CharacterMovement->GetMaxBrakingDeceleration();
+	MaxSimulationTimeStep = CharacterMovement->MaxSimulationTimeStep;
+	bIsValid = true;
+}
+
+FParagonLocomotionSettings::FParagonLocomotionSettings()
+	: LeanFactor(0.3f)
+	, LeanInterpSpeed(10.f)
+	, MeshRotationInterpSpeed(10.f)
+	, DistanceMachingScaling(1.f)
+	, bPredictStop(true)
+	, FixedUpdateRate(0.f)
+{
+}
+
+FParagonLocomotionState::FParagonLocomotionState()
+	: IsAccelerating(false)
+	, IsMoving(false)
+	, Lean(0.f)
+	, CardinalDirection(EAnimCardinalDirection::North)
+	, AimYaw(0.f)
+	, AimPitch(0.f)
+	, DistanceMachingStart(0.f)
+	, DistanceMachingStop(0.f)
+	, RootYawOffset(0.f)
+	, ActorRotation(FRotator::ZeroRotator)
+	, MeshRotation(FRotator::ZeroRotator)
+	, DistanceMachingStartLocation(FVector::ZeroVector)
+	, DistanceMachingStopLocation(FVector::ZeroVector)
+	, bStartedThisUpdate(false)
+	, bStoppedThisUpdate(false)
+{
+}
+
+FParagonLocomotionFixedStep::FParagonLocomotionFixedStep()
+	: Accumulator(0.f)
+	, bInitialized(false)
+{
+}
+
+void ParagonLocomotion::Initialize(FParagonLocomotionState& State, const FParagonLocomotionInput& Input)
+{
+	State.ActorRotation = Input.ActorRotation;
+	State.MeshRotation = Input.BaseRotationOffset + Input.ActorRotation;
+}
+
+void ParagonLocomotion::Update(FParagonLocomotionState& State, const FParagonLocomotionSettings& Settings, const FParagonLocomotionInput& Input, float DeltaSeconds)
+{
+	const FVector& CurrentActorLoaction = Input.ActorLocation;
+	const FVector& CurrentAcceleration = Input.Acceleration;
+	const FRotator& BaseMeshRotationOffset = Input.BaseRotationOffset;
+
+	const bool IsAcceleratingNow = !CurrentAcceleration.IsNearlyZero();
+
+	State.bStartedThisUpdate = false;
+	State.bStoppedThisUpdate = false;
+
+	if (IsAcceleratingNow != State.IsAccelerating)
+	{
+		if (IsAcceleratingNow)
+		{
+			State.DistanceMachingStartLocation = CurrentActorLoaction;
+			State.bStartedThisUpdate = true;
+		}
+		else if (Settings.bPredictStop)
+		{
+			PredictStopLocation(
+				State.DistanceMachingStopLocation,
+				CurrentActorLoaction,
+				Input.Velocity,
+				CurrentAcceleration,
+				Input.BrakingFriction,
+				Input.BrakingDeceleration,
+				Input.MaxSimulationTimeStep,
+				100);
+			State.bStoppedThisUpdate = true;
+		}
+		else
+		{
+			EstimateStopLocation(State.DistanceMachingStopLocation, CurrentActorLoaction, Input.Velocity, Input.BrakingDeceleration);
+			State.bStoppedThisUpdate = true;
+		}
+	}
+
+	State.DistanceMachingStart = FVector::Dist2D(CurrentActorLoaction, State.DistanceMachingStartLocation) * Settings.DistanceMachingScaling;
+	State.DistanceMachingStop = -FVector::Dist2D(CurrentActorLoaction, State.DistanceMachingStopLocation) * Settings.DistanceMachingScaling;
+
+	State.IsAccelerating = IsAcceleratingNow;
+	State.IsMoving = !Input.Velocity.IsNearlyZero();
+
+	float YawDelta = FMath::FindDeltaAngleDegrees(State.ActorRotation.Yaw, Input.ActorRotation.Yaw);
+	State.Lean = FMath::FInterpTo(State.Lean, YawDelta / DeltaSeconds * Settings.LeanFactor, DeltaSeconds, Settings.LeanInterpSpeed);
+
+	// The mesh is attached to the actor and turns with it while idle, keep the root yaw offset relative to the actor too
+	if (!State.IsAccelerating)
+	{
+		State.MeshRotation.Yaw = FRotator::NormalizeAxis(State.MeshRotation.Yaw + YawDelta);
+	}
+
+	State.ActorRotation = Input.ActorRotation;
+
+	if (State.IsAccelerating)
+	{
+		const FRotator InputRotation = CurrentAcceleration.ToOrientationRotator();
+		const ParagonCore::FCardinalDirectionResult Cardinal = ParagonCore::ClassifyCardinalDirection(InputRotation.Yaw, State.ActorRotation.Yaw);
+		State.CardinalDirection = (EAnimCardinalDirection)Cardinal.Direction;
+
+		const FRotator CardinalDirectionRotation(0.f, Cardinal.MeshYawOffset, 0.f);
+		const FRotator TargetMeshRotation = BaseMeshRotationOffset + CardinalDirectionRotation + State.ActorRotation;
+		State.MeshRotation = FMath::RInterpTo(State.MeshRotation, TargetMeshRotation, DeltaSeconds, Settings.MeshRotationInterpSpeed);
+	}
+
+	FRotator AimDelta = Input.BaseAimRotation - (State.MeshRotation - BaseMeshRotationOffset);
+	AimDelta.Normalize();
+	State.AimYaw = AimDelta.Yaw;
+	State.AimPitch = AimDelta.Pitch;
+
+	State.RootYawOffset = FRotator::NormalizeAxis(State.MeshRotation.Yaw - (BaseMeshRotationOffset.Yaw + State.ActorRotation.Yaw));
+}
+
+void ParagonLocomotion::UpdateFixedStep(FParagonLocomotionState& State, FParagonLocomotionFixedStep& FixedStep, const FParagonLocomotionSettings& Settings, const FParagonLocomotionInput& Input, float DeltaSeconds)
+{
+	if (Settings.FixedUpdateRate <= 0.f)
+	{
+		Update(State, Settings, Input, DeltaSeconds);
+		FixedStep.bInitialized = false;
+		return;
+	}
+
+	if (!FixedStep.bInitialized)
+	{
+		FixedStep.Previous = State;
+		FixedStep.Current = State;
+		FixedStep.Accumulator = 0.f;
+		FixedStep.bInitialized = true;
+	}
+
+	// A hitch runs a few steps and drops the rest of the time instead of catching up
+	const int32 MaxStepsPerUpdate = 4;
+	const float StepTime = 1.f / Settings.FixedUpdateRate;
+	FixedStep.Accumulator = FMath::Min(FixedStep.Accumulator + DeltaSeconds, StepTime * MaxStepsPerUpdate);
+
+	bool bStarted = false;
+	bool bStopped = false;
+	while (FixedStep.Accumulator >= StepTime)
+	{
+		FixedStep.Accumulator -= StepTime;
+		FixedStep.Previous = FixedStep.Current;
+		Update(FixedStep.Current, Settings, Input, StepTime);
+		bStarted |= FixedStep.Current.bStartedThisUpdate;
+		bStopped |= FixedStep.Current.bStoppedThisUpdate;
+	}
+
+	const FParagonLocomotionState& Previous = FixedStep.Previous;
+	const FParagonLocomotionState& Current = FixedStep.Current;
+	const float Alpha = FixedStep.Accumulator / StepTime;
+
+	State = Current;
+	State.bStartedThisUpdate = bStarted;
+	State.bStoppedThisUpdate = bStopped;
+
+	State.Lean = FMath::Lerp(Previous.Lean, Current.Lean, Alpha);
+	State.MeshRotation = FMath::Lerp(Previous.MeshRotation, Current.MeshRotation, Alpha);
+
+	// Cheap enough to follow the character every tick, the start and stop locations only change on a step
+	State.DistanceMachingStart = FVector::Dist2D(Input.ActorLocation, Current.DistanceMachingStartLocation) * Settings.DistanceMachingScaling;
+	State.DistanceMachingStop = -FVector::Dist2D(Input.ActorLocation, Current.DistanceMachingStopLocation) * Settings.DistanceMachingScaling;
+	State.IsMoving = !Input.Velocity.IsNearlyZero();
+
+	FRotator AimDelta = Input.BaseAimRotation - (State.MeshRotation - Input.BaseRotationOffset);
+	AimDelta.Normalize();
+	State.AimYaw = AimDelta.Yaw;
+	State.AimPitch = AimDelta.Pitch;
+
+	State.ActorRotation = Input.ActorRotation;
+	State.RootYawOffset = FRotator::NormalizeAxis(State.MeshRotation.Yaw - (Input.BaseRotationOffset.Yaw + Input.ActorRotation.Yaw));
+}
+
+void ParagonLocomotion::ConsumeTurnYaw(FParagonLocomotionState& State, FParagonLocomotionFixedStep& FixedStep, const FParagonLocomotionInput& Input, float TurnedYaw)
+{
+	auto Consume = [&Input, TurnedYaw](FParagonLocomotionState& InOutState)
+	{
+		InOutState.RootYawOffset = ParagonCore::ConsumeTurnYaw(InOutState.RootYawOffset, TurnedYaw);
+		InOutState.MeshRotation.Yaw = FRotator::NormalizeAxis(Input.BaseRotationOffset.Yaw + InOutState.ActorRotation.Yaw + InOutState.RootYawOffset);
+	};
+
+	Consume(State);
+	if (FixedStep.bInitialized)
+	{
+		Consume(FixedStep.Previous);
+		Consume(FixedStep.Current);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	/** Sweep friction, deceleration and speed and log how far the closed form drifts from the simulated stop location */
+	void CompareStopPrediction(const TArray<FString>& Args)
+	{
+		const float TimeStep = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 0.05f;
+		const float Tolerance = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 0.01f;
+
+		const float Frictions[] = { 0.5f, 1.f, 2.f, 4.f, 8.f, 20.f };
+		const float Decelerations[] = { 0.f, 256.f, 512.f, 1024.f, 2048.f, 4096.f };
+		const float Speeds[] = { 5.f, 50.f, 150.f, 300.f, 600.f, 1200.f };
+
+		int32 NumCases = 0;
+		int32 NumFailures = 0;
+		float MaxError = 0.f;
+
+		for (float Friction : Frictions)
+		{
+			for (float Deceleration : Decelerations)
+			{
+				for (float Speed : Speeds)
+				{
+					const FVector Velocity(Speed, 0.f, 0.f);
+					FVector Simulated = FVector::ZeroVector;
+					FVector ClosedForm = FVector::ZeroVector;
+					const bool bSimulated = ParagonLocomotion::PredictStopLocation(Simulated, FVector::ZeroVector, Velocity, FVector::ZeroVector, Friction, Deceleration, TimeStep, 100, false);
+					const bool bClosedForm = ParagonLocomotion::PredictStopLocation(ClosedForm, FVector::ZeroVector, Velocity, FVector::ZeroVector, Friction, Deceleration, TimeStep, 100, true);
+
+					NumCases++;
+
+					const float SimulatedDistance = Simulated.Size();
+					const float Error = FMath::Abs(ClosedForm.Size() - SimulatedDistance);
+					const float AllowedError = FMath::Max(SimulatedDistance * Tolerance, 1.f);
+					if (bSimulated != bClosedForm || Error > AllowedError)
+					{
+						NumFailures++;
+						UE_LOG(LogAnimation, Warning, TEXT("Stop prediction mismatch: Friction %.2f Deceleration %.1f Speed %.1f, simulated %d %.2f, closed form %d %.2f"),
+							Friction, Deceleration, Speed, bSimulated, SimulatedDistance, bClosedForm, ClosedForm.Size());
+					}
+
+					if (bSimulated && bClosedForm)
+					{
+						MaxError = FMath::Max(MaxError, Error);
+					}
+				}
+			}
+		}
+
+		UE_LOG(LogAnimation, Display, TEXT("Stop prediction: %d cases, %d outside tolerance, max error %.2f"), NumCases, NumFailures, MaxError);
+	}
+
+	FAutoConsoleCommand CompareStopPredictionCommand(
+		TEXT("Paragon.CompareStopPrediction"),
+		TEXT("Compare the closed form stop prediction against the simulation. Args: [TimeStep] [RelativeTolerance]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&CompareStopPrediction));
+}
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,400 @@
+#include "ParagonLocomotionBatch.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "ParagonCore/TurnInPlace.h"
+
+int32 FParagonLocomotionBatch::BatchSize = 256;
+
+namespace
+{
+	FAutoConsoleVariableRef CVarLocomotionBatchSize(
+		TEXT("Paragon.LocomotionBatchSize"),
+		FParagonLocomotionBatch::BatchSize,
+		TEXT("Number of characters updated by one task of the batched locomotion update."));
+
+	/** Same result as FRotator::NormalizeAxis, without branches */
+	FORCEINLINE float NormalizeAxis(float Angle)
+	{
+		return Angle - 360.f * FMath::FloorToFloat((Angle + 180.f) / 360.f);
+	}
+
+	FORCEINLINE float Select(bool bCondition, float A, float B)
+	{
+		return bCondition ? A : B;
+	}
+
+	FORCEINLINE bool IsNearlyZero(float X, float Y, float Z)
+	{
+		return FMath::Abs(X) <= KINDA_SMALL_NUMBER && FMath::Abs(Y) <= KINDA_SMALL_NUMBER && FMath::Abs(Z) <= KINDA_SMALL_NUMBER;
+	}
+}
+
+template <typename FuncType>
+void FParagonLocomotionBatch::ForEachArray(FuncType&& Func)
+{
+	Func(Active);
+	Func(LocationX); Func(LocationY); Func(LocationZ);
+	Func(AccelerationX); Func(AccelerationY); Func(AccelerationZ);
+	Func(VelocityX); Func(VelocityY); Func(VelocityZ);
+	Func(ActorPitch); Func(ActorYaw); Func(ActorRoll);
+	Func(OffsetPitch); Func(OffsetYaw); Func(OffsetRoll);
+	Func(AimRotationPitch); Func(AimRotationYaw); Func(AimRotationRoll);
+	Func(BrakingFriction); Func(BrakingDeceleration); Func(MaxSimulationTimeStep);
+	Func(LeanFactor); Func(LeanInterpSpeed); Func(MeshRotationInterpSpeed); Func(DistanceMachingScaling);
+	Func(PredictStop);
+
+	Func(IsAccelerating); Func(IsMoving); Func(Started); Func(Stopped);
+	Func(CardinalDirection);
+	Func(Lean); Func(AimYaw); Func(AimPitch); Func(RootYawOffset);
+	Func(DistanceMachingStart); Func(DistanceMachingStop);
+	Func(LastActorPitch); Func(LastActorYaw); Func(LastActorRoll);
+	Func(MeshPitch); Func(MeshYaw); Func(MeshRoll);
+	Func(StartX); Func(StartY); Func(StartZ);
+	Func(StopX); Func(StopY); Func(StopZ);
+}
+
+int32 FParagonLocomotionBatch::Add(const FParagonLocomotionState& State)
+{
+	ForEachArray([](auto& Array) { Array.AddZeroed(); });
+
+	const int32 Index = NumSlots++;
+	SetState(Index, State);
+	return Index;
+}
+
+void FParagonLocomotionBatch::RemoveAtSwap(int32 Index)
+{
+	check(Index >= 0 && Index < NumSlots);
+	ForEachArray([Index](auto& Array) { Array.RemoveAtSwap(Index, 1, false); });
+	NumSlots--;
+}
+
+void FParagonLocomotionBatch::Reset()
+{
+	ForEachArray([](auto& Array) { Array.Reset(); });
+	NumSlots = 0;
+}
+
+void FParagonLocomotionBatch::SetInput(int32 Index, const FParagonLocomotionInput& Input, const FParagonLocomotionSettings& Settings)
+{
+	Active[Index] = Input.bIsValid;
+	if (!Input.bIsValid)
+	{
+		return;
+	}
+
+	LocationX[Index] = Input.ActorLocation.X;
+	LocationY[Index] = Input.ActorLocation.Y;
+	LocationZ[Index] = Input.ActorLocation.Z;
+	AccelerationX[Index] = Input.Acceleration.X;
+	AccelerationY[Index] = Input.Acceleration.Y;
+	AccelerationZ[Index] = Input.Acceleration.Z;
+	VelocityX[Index] = Input.Velocity.X;
+	VelocityY[Index] = Input.Velocity.Y;
+	VelocityZ[Index] = Input.Velocity.Z;
+	ActorPitch[Index] = Input.ActorRotation.Pitch;
+	ActorYaw[Index] = Input.ActorRotation.Yaw;
+	ActorRoll[Index] = Input.ActorRotation.Roll;
+	OffsetPitch[Index] = Input.BaseRotationOffset.Pitch;
+	OffsetYaw[Index] = Input.BaseRotationOffset.Yaw;
+	OffsetRoll[Index] = Input.BaseRotationOffset.Roll;
+	AimRotationPitch[Index] = Input.BaseAimRotation.Pitch;
+	AimRotationYaw[Index] = Input.BaseAimRotation.Yaw;
+	AimRotationRoll[Index] = Input.BaseAimRotation.Roll;
+	BrakingFriction[Index] = Input.BrakingFriction;
+	BrakingDeceleration[Index] = Input.BrakingDeceleration;
+	MaxSimulationTimeStep[Index] = Input.MaxSimulationTimeStep;
+
+	LeanFactor[Index] = Settings.LeanFactor;
+	LeanInterpSpeed[Index] = Settings.LeanInterpSpeed;
+	MeshRotationInterpSpeed[Index] = Settings.MeshRotationInterpSpeed;
+	DistanceMachingScaling[Index] = Settings.DistanceMachingScaling;
+	PredictStop[Index] = Settings.bPredictStop;
+}
+
+void FParagonLocomotionBatch::SetState(int32 Index, const FParagonLocomotionState& State)
+{
+	IsAccelerating[Index] = State.IsAccelerating;
+	IsMoving[Index] = State.IsMoving;
+	Started[Index] = State.bStartedThisUpdate;
+	Stopped[Index] = State.bStoppedThisUpdate;
+	CardinalDirection[Index] = (uint8)State.CardinalDirection;
+	Lean[Index] = State.Lean;
+	AimYaw[Index] = State.AimYaw;
+	AimPitch[Index] = State.AimPitch;
+	RootYawOffset[Index] = State.RootYawOffset;
+	DistanceMachingStart[Index] = State.DistanceMachingStart;
+	DistanceMachingStop[Index] = State.DistanceMachingStop;
+	LastActorPitch[Index] = State.ActorRotation.Pitch;
+	LastActorYaw[Index] = State.ActorRotation.Yaw;
+	LastActorRoll[Index] = State.ActorRotation.Roll;
+	MeshPitch[Index] = State.MeshRotation.Pitch;
+	MeshYaw[Index] = State.MeshRotation.Yaw;
+	MeshRoll[Index] = State.MeshRotation.Roll;
+	StartX[Index] = State.DistanceMachingStartLocation.X;
+	StartY[Index] = State.DistanceMachingStartLocation.Y;
+	StartZ[Index] = State.DistanceMachingStartLocation.Z;
+	StopX[Index] = State.DistanceMachingStopLocation.X;
+	StopY[Index] = State.DistanceMachingStopLocation.Y;
+	StopZ[Index] = State.DistanceMachingStopLocation.Z;
+}
+
+void FParagonLocomotionBatch::GetState(int32 Index, FParagonLocomotionState& OutState) const
+{
+	OutState.IsAccelerating = IsAccelerating[Index] != 0;
+	OutState.IsMoving = IsMoving[Index] != 0;
+	OutState.bStartedThisUpdate = Started[Index] != 0;
+	OutState.bStoppedThisUpdate = Stopped[Index] != 0;
+	OutState.CardinalDirection = (EAnimCardinalDirection)CardinalDirection[Index];
+	OutState.Lean = Lean[Index];
+	OutState.AimYaw = AimYaw[Index];
+	OutState.AimPitch = AimPitch[Index];
+	OutState.RootYawOffset = RootYawOffset[Index];
+	OutState.DistanceMachingStart = DistanceMachingStart[Index];
+	OutState.DistanceMachingStop = DistanceMachingStop[Index];
+	OutState.ActorRotation = FRotator(LastActorPitch[Index], LastActorYaw[Index], LastActorRoll[Index]);
+	OutState.MeshRotation = FRotator(MeshPitch[Index], MeshYaw[Index], MeshRoll[Index]);
+	OutState.DistanceMachingStartLocation = FVector(StartX[Index], StartY[Index], StartZ[Index]);
+	OutState.DistanceMachingStopLocation = FVector(StopX[Index], StopY[Index], StopZ[Index]);
+}
+
+void FParagonLocomotionBatch::ConsumeTurnYaw(int32 Index, float TurnedYaw)
+{
+	RootYawOffset[Index] = ParagonCore::ConsumeTurnYaw(RootYawOffset[Index], TurnedYaw);
+	MeshYaw[Index] = FRotator::NormalizeAxis(OffsetYaw[Index] + LastActorYaw[Index] + RootYawOffset[Index]);
+}
+
+void FParagonLocomotionBatch::Update(float DeltaSeconds)
+{
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumSlots, FMath::Max(BatchSize, 1));
+	ParallelFor(NumBatches, [this, DeltaSeconds](int32 BatchIndex)
+	{
+		const int32 Begin = BatchIndex * FMath::Max(BatchSize, 1);
+		const int32 End = FMath::Min(Begin + FMath::Max(BatchSize, 1), NumSlots);
+		UpdateRange(Begin, End, DeltaSeconds);
+	}, NumBatches < 2);
+}
+
+void FParagonLocomotionBatch::UpdateRange(int32 Begin, int32 End, float DeltaSeconds)
+{
+	const float InvDeltaSeconds = DeltaSeconds > 0.f ? 1.f / DeltaSeconds : 0.f;
+
+	// Acceleration transitions, start locations
+	for (int32 i = Begin; i < End; i++)
+	{
+		const bool bActive = Active[i] != 0;
+		const bool bAcceleratingNow = !IsNearlyZero(AccelerationX[i], AccelerationY[i], AccelerationZ[i]);
+		const bool bWasAccelerating = IsAccelerating[i] != 0;
+
+		Started[i] = bActive & bAcceleratingNow & !bWasAccelerating;
+		Stopped[i] = bActive & !bAcceleratingNow & bWasAccelerating;
+		IsAccelerating[i] = bActive ? bAcceleratingNow : bWasAccelerating;
+		IsMoving[i] = bActive ? !IsNearlyZero(VelocityX[i], VelocityY[i], VelocityZ[i]) : IsMoving[i];
+
+		StartX[i] = Select(Started[i] != 0, LocationX[i], StartX[i]);
+		StartY[i] = Select(Started[i] != 0, LocationY[i], StartY[i]);
+		StartZ[i] = Select(Started[i] != 0, LocationZ[i], StartZ[i]);
+	}
+
+	// Stop prediction is rare and stays scalar
+	for (int32 i = Begin; i < End; i++)
+	{
+		if (Stopped[i] && !PredictStop[i])
+		{
+			FVector StopLocation;
+			ParagonLocomotion::EstimateStopLocation(StopLocation, FVector(LocationX[i], LocationY[i], LocationZ[i]), FVector(VelocityX[i], VelocityY[i], VelocityZ[i]), BrakingDeceleration[i]);
+			StopX[i] = StopLocation.X;
+			StopY[i] = StopLocation.Y;
+			StopZ[i] = StopLocation.Z;
+		}
+		else if (Stopped[i])
+		{
+			FVector StopLocation(StopX[i], StopY[i], StopZ[i]);
+			ParagonLocomotion::PredictStopLocation(
+				StopLocation,
+				FVector(LocationX[i], LocationY[i], LocationZ[i]),
+				FVector(VelocityX[i], VelocityY[i], VelocityZ[i]),
+				FVector(AccelerationX[i], AccelerationY[i], AccelerationZ[i]),
+				BrakingFriction[i],
+				BrakingDeceleration[i],
+				MaxSimulationTimeStep[i],
+				100);
+			StopX[i] = StopLocation.X;
+			StopY[i] = StopLocation.Y;
+			StopZ[i] = StopLocation.Z;
+		}
+	}
+
+	// Distances
+	for (int32 i = Begin; i < End; i++)
+	{
+		const bool bActive = Active[i] != 0;
+		const float StartDistance = FMath::Sqrt(FMath::Square(LocationX[i] - StartX[i]) + FMath::Square(LocationY[i] - StartY[i])) * DistanceMachingScaling[i];
+		const float StopDistance = -FMath::Sqrt(FMath::Square(LocationX[i] - StopX[i]) + FMath::Square(LocationY[i] - StopY[i])) * DistanceMachingScaling[i];
+		DistanceMachingStart[i] = Select(bActive, StartDistance, DistanceMachingStart[i]);
+		DistanceMachingStop[i] = Select(bActive, StopDistance, DistanceMachingStop[i]);
+	}
+
+	// Lean
+	for (int32 i = Begin; i < End; i++)
+	{
+		const bool bActive = Active[i] != 0;
+		const float YawDelta = NormalizeAxis(ActorYaw[i] - LastActorYaw[i]);
+		const float Target = YawDelta * InvDeltaSeconds * LeanFactor[i];
+		const float Distance = Target - Lean[i];
+		const bool bSnap = LeanInterpSpeed[i] <= 0.f || Distance * Distance < SMALL_NUMBER;
+		const float Alpha = FMath::Clamp(DeltaSeconds * LeanInterpSpeed[i], 0.f, 1.f);
+		const float NewLean = Select(bSnap, Target, Lean[i] + Distance * Alpha);
+		Lean[i] = Select(bActive, NewLean, Lean[i]);
+
+		// Idle meshes turn with the actor, see ParagonLocomotion::Update
+		const bool bFollowActor = bActive & (IsAccelerating[i] == 0);
+		MeshYaw[i] = Select(bFollowActor, NormalizeAxis(MeshYaw[i] + YawDelta), MeshYaw[i]);
+
+		LastActorPitch[i] = Select(bActive, ActorPitch[i], LastActorPitch[i]);
+		LastActorYaw[i] = Select(bActive, ActorYaw[i], LastActorYaw[i]);
+		LastActorRoll[i] = Select(bActive, ActorRoll[i], LastActorRoll[i]);
+	}
+
+	// Cardinal direction and mesh rotation
+	for (int32 i = Begin; i < End; i++)
+	{
+		const bool bUpdate = (Active[i] != 0) & (IsAccelerating[i] != 0);
+
+		const float InputYaw = FMath::RadiansToDegrees(FMath::Atan2(AccelerationY[i], AccelerationX[i]));
+		const float InputDelta = NormalizeAxis(ActorYaw[i] - InputYaw);
+		const float AbsDelta = FMath::Abs(InputDelta);
+		const bool bNorth = AbsDelta < 70.f;
+		const bool bSouth = AbsDelta > 110.f;
+		const bool bWest = InputDelta > 0.f;
+
+		const uint8 Direction = bNorth ? (uint8)EAnimCardinalDirection::North
+			: bSouth ? (uint8)EAnimCardinalDirection::South
+			: bWest ? (uint8)EAnimCardinalDirection::West
+			: (uint8)EAnimCardinalDirection::East;
+		const float DirectionOffset = Select(bNorth, 0.f, Select(bSouth, 180.f, Select(bWest, -90.f, 90.f)));
+		const float CardinalDirectionAngle = -(InputDelta + DirectionOffset);
+
+		CardinalDirection[i] = bUpdate ? Direction : CardinalDirection[i];
+
+		const float Alpha = Select(MeshRotationInterpSpeed[i] <= 0.f, 1.f, FMath::Clamp(DeltaSeconds * MeshRotationInterpSpeed[i], 0.f, 1.f));
+		const float TargetPitch = OffsetPitch[i] + ActorPitch[i];
+		const float TargetYaw = OffsetYaw[i] + CardinalDirectionAngle + ActorYaw[i];
+		const float TargetRoll = OffsetRoll[i] + ActorRoll[i];
+		const float NewPitch = NormalizeAxis(MeshPitch[i] + NormalizeAxis(TargetPitch - MeshPitch[i]) * Alpha);
+		const float NewYaw = NormalizeAxis(MeshYaw[i] + NormalizeAxis(TargetYaw - MeshYaw[i]) * Alpha);
+		const float NewRoll = NormalizeAxis(MeshRoll[i] + NormalizeAxis(TargetRoll - MeshRoll[i]) * Alpha);
+
+		MeshPitch[i] = Select(bUpdate, NewPitch, MeshPitch[i]);
+		MeshYaw[i] = Select(bUpdate, NewYaw, MeshYaw[i]);
+		MeshRoll[i] = Select(bUpdate, NewRoll, MeshRoll[i]);
+	}
+
+	// Aim
+	for (int32 i = Begin; i < End; i++)
+	{
+		const bool bActive = Active[i] != 0;
+		const float NewAimPitch = NormalizeAxis(AimRotationPitch[i] - (MeshPitch[i] - OffsetPitch[i]));
+		const float NewAimYaw = NormalizeAxis(AimRotationYaw[i] - (MeshYaw[i] - OffsetYaw[i]));
+		const float NewRootYawOffset = NormalizeAxis(MeshYaw[i] - (OffsetYaw[i] + ActorYaw[i]));
+		AimPitch[i] = Select(bActive, NewAimPitch, AimPitch[i]);
+		AimYaw[i] = Select(bActive, NewAimYaw, AimYaw[i]);
+		RootYawOffset[i] = Select(bActive, NewRootYawOffset, RootYawOffset[i]);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	/** Generates a deterministic start, jog, turn and stop pattern per character */
+	void MakeBenchmarkInput(FParagonLocomotionInput& Input, FRandomStream& Random, int32 Frame, float DeltaSeconds)
+	{
+		const bool bAccelerating = ((Frame / 60) % 3) != 2;
+		const float Heading = Random.FRandRange(-180.f, 180.f);
+		const FVector Direction = FRotator(0.f, Heading, 0.f).Vector();
+
+		Input.bIsValid = true;
+		Input.Acceleration = bAccelerating ? Direction * 2048.f : FVector::ZeroVector;
+		Input.Velocity = Direction * (bAccelerating ? 600.f : 200.f);
+		Input.ActorLocation += Input.Velocity * DeltaSeconds;
+		Input.ActorRotation.Yaw = FRotator::NormalizeAxis(Input.ActorRotation.Yaw + Random.FRandRange(-5.f, 5.f));
+		Input.BaseRotationOffset = FRotator(0.f, -90.f, 0.f);
+		Input.BaseAimRotation = FRotator(Random.FRandRange(-30.f, 30.f), Input.ActorRotation.Yaw + Random.FRandRange(-60.f, 60.f), 0.f);
+		Input.BrakingFriction = 2.f;
+		Input.BrakingDeceleration = 2048.f;
+		Input.MaxSimulationTimeStep = 0.05f;
+	}
+
+	void BenchmarkLocomotion(const TArray<FString>& Args)
+	{
+		const int32 NumFrames = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 300;
+		const float DeltaSeconds = 1.f / 30.f;
+		const int32 Counts[] = { 100, 1000, 5000 };
+
+		const FParagonLocomotionSettings Settings;
+
+		for (int32 Count : Counts)
+		{
+			TArray<FParagonLocomotionInput> Inputs;
+			Inputs.SetNum(Count);
+			TArray<FParagonLocomotionState> States;
+			States.SetNum(Count);
+
+			FParagonLocomotionBatch Batch;
+			for (int32 i = 0; i < Count; i++)
+			{
+				Batch.Add(States[i]);
+			}
+
+			FRandomStream Random(1234);
+			double PerInstanceSeconds = 0.0;
+			double BatchedSeconds = 0.0;
+			float MaxError = 0.f;
+
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				for (FParagonLocomotionInput& Input : Inputs)
+				{
+					MakeBenchmarkInput(Input, Random, Frame, DeltaSeconds);
+				}
+
+				double StartTime = FPlatformTime::Seconds();
+				for (int32 i = 0; i < Count; i++)
+				{
+					ParagonLocomotion::Update(States[i], Settings, Inputs[i], DeltaSeconds);
+				}
+				PerInstanceSeconds += FPlatformTime::Seconds() - StartTime;
+
+				StartTime = FPlatformTime::Seconds();
+				for (int32 i = 0; i < Count; i++)
+				{
+					Batch.SetInput(i, Inputs[i], Settings);
+				}
+				Batch.Update(DeltaSeconds);
+				BatchedSeconds += FPlatformTime::Seconds() - StartTime;
+
+				for (int32 i = 0; i < Count; i++)
+				{
+					FParagonLocomotionState BatchedState;
+					Batch.GetState(i, BatchedState);
+					MaxError = FMath::Max(MaxError, FMath::Abs(FRotator::NormalizeAxis(BatchedState.AimYaw - States[i].AimYaw)));
+					MaxError = FMath::Max(MaxError, FMath::Abs(BatchedState.DistanceMachingStop - States[i].DistanceMachingStop));
+				}
+			}
+
+			UE_LOG(LogAnimation, Display, TEXT("Locomotion %5d characters: per instance %.3f ms/frame, batched %.3f ms/frame, speedup %.2fx, max difference %.4f"),
+				Count,
+				PerInstanceSeconds * 1000.0 / NumFrames,
+				BatchedSeconds * 1000.0 / NumFrames,
+				BatchedSeconds > 0.0 ? PerInstanceSeconds / BatchedSeconds : 0.0,
+				MaxError);
+		}
+	}
+
+	FAutoConsoleCommand BenchmarkLocomotionCommand(
+		TEXT("Paragon.BenchmarkLocomotion"),
+		TEXT("Compare the per instance and the batched locomotion update at 100, 1000 and 5000 characters. Args: [NumFrames]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkLocomotion));
+}
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,201 @@
+#include "ParagonLocomotionRecording.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+namespace
+{
+	const uint32 RecordingMagic = 0x434C5250; // "PRLC"
+	const int32 RecordingVersion = 2;
+
+	enum ERecordedFrameFlags : uint8
+	{
+		FrameFlag_InputValid = 1 << 0,
+		FrameFlag_Settings = 1 << 1,
+	};
+
+	void SerializeRotator(FArchive& Ar, FRotator& Rotator)
+	{
+		Ar << Rotator.Pitch << Rotator.Yaw << Rotator.Roll;
+	}
+
+	void SerializeInput(FArchive& Ar, FParagonLocomotionInput& Input)
+	{
+		Ar << Input.ActorLocation << Input.Acceleration << Input.Velocity;
+		SerializeRotator(Ar, Input.ActorRotation);
+		SerializeRotator(Ar, Input.BaseRotationOffset);
+		SerializeRotator(Ar, Input.BaseAimRotation);
+		Ar << Input.BrakingFriction << Input.BrakingDeceleration << Input.MaxSimulationTimeStep;
+	}
+
+	void SerializeState(FArchive& Ar, FParagonLocomotionState& State)
+	{
+		uint8 CardinalDirection = (uint8)State.CardinalDirection;
+		Ar << State.IsAccelerating << State.IsMoving << State.Lean << CardinalDirection << State.AimYaw << State.AimPitch;
+		Ar << State.DistanceMachingStart << State.DistanceMachingStop << State.RootYawOffset;
+		SerializeRotator(Ar, State.ActorRotation);
+		SerializeRotator(Ar, State.MeshRotation);
+		Ar << State.DistanceMachingStartLocation << State.DistanceMachingStopLocation;
+		Ar << State.bStartedThisUpdate << State.bStoppedThisUpdate;
+		State.CardinalDirection = (EAnimCardinalDirection)CardinalDirection;
+	}
+
+	void SerializeFixedStep(FArchive& Ar, FParagonLocomotionFixedStep& FixedStep)
+	{
+		SerializeState(Ar, FixedStep.Previous);
+		SerializeState(Ar, FixedStep.Current);
+		Ar << FixedStep.Accumulator << FixedStep.bInitialized;
+	}
+
+	void SerializeSettings(FArchive& Ar, FParagonLocomotionSettings& Settings)
+	{
+		Ar << Settings.LeanFactor << Settings.LeanInterpSpeed << Settings.MeshRotationInterpSpeed << Settings.DistanceMachingScaling;
+		Ar << Settings.bPredictStop << Settings.FixedUpdateRate;
+	}
+
+	bool SettingsEqual(const FParagonLocomotionSettings& A, const FParagonLocomotionSettings& B)
+	{
+		return A.LeanFactor == B.LeanFactor
+			&& A.LeanInterpSpeed == B.LeanInterpSpeed
+			&& A.MeshRotationInterpSpeed == B.MeshRotationInterpSpeed
+			&& A.DistanceMachingScaling == B.DistanceMachingScaling
+			&& A.bPredictStop == B.bPredictStop
+			&& A.FixedUpdateRate == B.FixedUpdateRate;
+	}
+}
+
+const TCHAR* ParagonLocomotionRecording::FileExtension = TEXT(".plr");
+
+FParagonLocomotionRecordedFrame::FParagonLocomotionRecordedFrame()
+	: DeltaSeconds(0.f)
+{
+}
+
+FParagonLocomotionRecorder::FParagonLocomotionRecorder()
+	: bHasSettings(false)
+	, NumFrames(0)
+{
+}
+
+FParagonLocomotionRecorder::~FParagonLocomotionRecorder()
+{
+	Close();
+}
+
+bool FParagonLocomotionRecorder::Open(const FString& Filename, const FParagonLocomotionState& State, const FParagonLocomotionFixedStep& FixedStep)
+{
+	Close();
+
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer.IsValid())
+	{
+		return false;
+	}
+
+	uint32 Magic = RecordingMagic;
+	int32 Version = RecordingVersion;
+	*Writer << Magic << Version;
+
+	FParagonLocomotionState StateCopy = State;
+	FParagonLocomotionFixedStep FixedStepCopy = FixedStep;
+	SerializeState(*Writer, StateCopy);
+	SerializeFixedStep(*Writer, FixedStepCopy);
+
+	bHasSettings = false;
+	NumFrames = 0;
+	return true;
+}
+
+void FParagonLocomotionRecorder::Close()
+{
+	if (Writer.IsValid())
+	{
+		Writer->Close();
+		Writer.Reset();
+	}
+}
+
+void FParagonLocomotionRecorder::Record(float DeltaSeconds, const FParagonLocomotionInput& Input, const FParagonLocomotionSettings& Settings)
+{
+	if (!Writer.IsValid())
+	{
+		return;
+	}
+
+	const bool bWriteSettings = !bHasSettings || !SettingsEqual(Settings, LastSettings);
+
+	uint8 Flags = 0;
+	Flags |= Input.bIsValid ? FrameFlag_InputValid : 0;
+	Flags |= bWriteSettings ? FrameFlag_Settings : 0;
+
+	*Writer << Flags << DeltaSeconds;
+
+	if (Input.bIsValid)
+	{
+		FParagonLocomotionInput InputCopy = Input;
+		SerializeInput(*Writer, InputCopy);
+	}
+
+	if (bWriteSettings)
+	{
+		LastSettings = Settings;
+		bHasSettings = true;
+		SerializeSettings(*Writer, LastSettings);
+	}
+
+	NumFrames++;
+}
+
+bool ParagonLocomotionRecording::Load(const FString& Filename, FParagonLocomotionState& OutState, FParagonLocomotionFixedStep& OutFixedStep, TArray<FParagonLocomotionRecordedFrame>& OutFrames)
+{
+	OutFrames.Reset();
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Reader.IsValid())
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	*Reader << Magic << Version;
+	if (Magic != RecordingMagic || Version != RecordingVersion)
+	{
+		return false;
+	}
+
+	SerializeState(*Reader, OutState);
+	SerializeFixedStep(*Reader, OutFixedStep);
+	if (Reader->IsError())
+	{
+		return false;
+	}
+
+	FParagonLocomotionSettings Settings;
+	while (!Reader->AtEnd() && !Reader->IsError())
+	{
+		FParagonLocomotionRecordedFrame& Frame = OutFrames.AddDefaulted_GetRef();
+
+		uint8 Flags = 0;
+		*Reader << Flags << Frame.DeltaSeconds;
+
+		Frame.Input.bIsValid = (Flags & FrameFlag_InputValid) != 0;
+		if (Frame.Input.bIsValid)
+		{
+			SerializeInput(*Reader, Frame.Input);
+		}
+
+		if (Flags & FrameFlag_Settings)
+		{
+			SerializeSettings(*Reader, Settings);
+		}
+		Frame.Settings = Settings;
+	}
+
+	// A recording that was cut off mid frame, such as from a crashed server, keeps its complete frames
+	if (Reader->IsError() && OutFrames.Num() > 0)
+	{
+		OutFrames.Pop();
+	}
+
+	return true;
+}
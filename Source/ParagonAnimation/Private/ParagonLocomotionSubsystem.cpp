@@ -0,0 +1,112 @@
+#include "ParagonLocomotionSubsystem.h"
+#include "ParagonAnimInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "ParagonAnimationBenchmark.h"
+#include "ParagonAnimationStats.h"
+
+void UParagonLocomotionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UParagonLocomotionSubsystem::OnWorldPostActorTick);
+}
+
+void UParagonLocomotionSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	Instances.Reset();
+	Batch.Reset();
+	Inputs.Reset();
+
+	Super::Deinitialize();
+}
+
+void UParagonLocomotionSubsystem::Register(UParagonAnimInstance* AnimInstance)
+{
+	if (!AnimInstance || Instances.Contains(AnimInstance))
+	{
+		return;
+	}
+
+	Instances.Add(AnimInstance);
+	Batch.Add(AnimInstance->GetParagonProxyOnGameThread().GetLocomotionState());
+}
+
+void UParagonLocomotionSubsystem::Unregister(UParagonAnimInstance* AnimInstance)
+{
+	const int32 Index = Instances.IndexOfByKey(AnimInstance);
+	if (Index != INDEX_NONE)
+	{
+		Instances.RemoveAtSwap(Index, 1, false);
+		Batch.RemoveAtSwap(Index);
+	}
+}
+
+void UParagonLocomotionSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld() || Instances.Num() == 0)
+	{
+		return;
+	}
+
+	PARAGON_BENCHMARK_SCOPE(InstanceUpdate);
+	PARAGON_SCOPE_CYCLE_COUNTER(STAT_ParagonBatchedUpdate);
+
+	// Drop instances destroyed without unregistering
+	for (int32 Index = Instances.Num() - 1; Index >= 0; Index--)
+	{
+		if (!Instances[Index].IsValid())
+		{
+			Instances.RemoveAtSwap(Index, 1, false);
+			Batch.RemoveAtSwap(Index);
+		}
+	}
+
+	// Gather
+	Inputs.SetNum(Instances.Num(), false);
+	Turned.Init(false, Instances.Num());
+	for (int32 Index = 0; Index < Instances.Num(); Index++)
+	{
+		UParagonAnimInstance* AnimInstance = Instances[Index].Get();
+
+		FParagonLocomotionInput& Input = Inputs[Index];
+		Input.Gather(Cast<ACharacter>(AnimInstance->TryGetPawnOwner()));
+		Batch.SetInput(Index, Input, AnimInstance->GetLocomotionSettings());
+
+		// The anim graph turned in place since the last batch, the proxy only turned its own copy of the state
+		const float TurnedYaw = AnimInstance->GetParagonProxyOnGameThread().ConsumePendingTurnYaw();
+		if (TurnedYaw != 0.f && Batch.IsActive(Index))
+		{
+			Batch.ConsumeTurnYaw(Index, TurnedYaw);
+			Turned[Index] = true;
+		}
+	}
+
+	Batch.Update(DeltaSeconds);
+
+	// Scatter
+	for (int32 Index = 0; Index < Instances.Num(); Index++)
+	{
+		if (!Batch.IsActive(Index))
+		{
+			continue;
+		}
+
+		UParagonAnimInstance* AnimInstance = Instances[Index].Get();
+
+		FParagonLocomotionState State;
+		Batch.GetState(Index, State);
+		AnimInstance->GetParagonProxyOnGameThread().SetBatchedLocomotionState(State, Inputs[Index]);
+
+		if ((State.IsAccelerating || Turned[Index]) && !AnimInstance->bRotateRootBone)
+		{
+			if (USkeletalMeshComponent* Mesh = AnimInstance->GetSkelMeshComponent())
+			{
+				Mesh->SetWorldRotation(State.MeshRotation);
+			}
+		}
+	}
+}
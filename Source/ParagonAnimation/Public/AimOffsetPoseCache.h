@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SharedAssetCache.h"
+
+class USkeleton;
+class UAnimSequence;
+
+/** Aim offset poses ordered from left to right, then from down to up */
+enum class EAimOffsetPose : uint8
+{
+	LeftDown,
+	CenterDown,
+	RightDown,
+	LeftCenter,
+	CenterCenter,
+	RightCenter,
+	LeftUp,
+	CenterUp,
+	RightUp,
+	Num,
+};
+
+/** The mesh space rotation additives of one aim offset pose set, extracted once for a skeleton */
+struct PARAGONANIMATION_API FAimOffsetPoseData : public FSharedAssetCacheEntry
+{
+	static const int32 NumPoses = (int32)EAimOffsetPose::Num;
+
+	/** Additive of every skeleton bone, pose after pose. Poses that are missing or not mesh space additives are identity */
+	TArray<FTransform> Transforms;
+	int32 NumBones = 0;
+
+	const FTransform& GetTransform(int32 Pose, int32 SkeletonBoneIndex) const { return Transforms[Pose * NumBones + SkeletonBoneIndex]; }
+};
+
+typedef TSharedPtr<const FAimOffsetPoseData, ESPMode::ThreadSafe> FAimOffsetPoseDataPtr;
+
+/** Key of the FAimOffsetPoseCache entries */
+struct PARAGONANIMATION_API FAimOffsetPoseKey
+{
+	FObjectKey Skeleton;
+	FObjectKey Poses[FAimOffsetPoseData::NumPoses];
+
+	bool Uses(const FObjectKey& Object) const;
+	bool IsStale() const;
+
+	bool operator==(const FAimOffsetPoseKey& Other) const;
+	friend uint32 GetTypeHash(const FAimOffsetPoseKey& Key)
+	{
+		uint32 Hash = GetTypeHash(Key.Skeleton);
+		for (const FObjectKey& Pose : Key.Poses)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Pose));
+		}
+		return Hash;
+	}
+};
+
+/**
+ * Process wide cache of decompressed aim offset poses.
+ * A pose set is extracted once per skeleton and shared by every node that plays it, lookups are safe from worker threads.
+ */
+class PARAGONANIMATION_API FAimOffsetPoseCache : public TSharedAssetCache<FAimOffsetPoseKey, FAimOffsetPoseData>
+{
+public:
+	static FAimOffsetPoseCache& Get();
+
+	/** Find the extracted poses, extracting them on first use. Poses holds FAimOffsetPoseData::NumPoses sequences */
+	FAimOffsetPoseDataPtr FindOrAdd(const USkeleton* Skeleton, const UAnimSequence* const* Poses);
+};
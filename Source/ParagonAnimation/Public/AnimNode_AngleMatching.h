@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Animation/AnimNode_AssetPlayerBase.h"
+#include "Animation/AnimSequenceBase.h"
+#include "DistanceCurveTable.h"
+#include "DistanceCurveRegistry.h"
+#include "AnimNode_AngleMatching.generated.h"
+
+/**
+ * Turn in place counterpart of FAnimNode_DistanceMatching, drives the clip time from the yaw that is left to turn.
+ * The curve holds minus the yaw left to turn at each time, rising to 0 at the end of the turn like a stop distance curve.
+ * The yaw the curve covers while the clip plays is handed back to the UParagonAnimInstance, which turns the mesh towards the actor.
+ */
+USTRUCT()
+struct PARAGONANIMATION_API FAnimNode_AngleMatching : public FAnimNode_AssetPlayerBase
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
+	UAnimSequenceBase* Sequence;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
+	FName CurveName;
+
+	/** Yaw left to turn in degrees, usually UParagonAnimInstance::RemainingTurnYaw. Only the magnitude is used */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	float RemainingYaw;
+
+	/** Turn the mesh of a UParagonAnimInstance towards the actor by the yaw the curve covered, which reduces RemainingTurnYaw to 0 */
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (NeverAsPin))
+	bool bConsumeTurnYaw;
+
+	/** Number of uniformly spaced samples used when baking the angle curve during compilation */
+	UPROPERTY(EditAnywhere, Category = Settings, AdvancedDisplay, meta = (NeverAsPin, ClampMin = "2", ClampMax = "4096"))
+	int32 BakedCurveSamples;
+
+	/** Angle curve of BakedSequence baked during compilation */
+	UPROPERTY()
+	FDistanceCurveTable BakedCurve;
+
+	UPROPERTY()
+	UAnimSequenceBase* BakedSequence;
+
+	UPROPERTY()
+	FName BakedCurveName;
+
+public:
+	FAnimNode_AngleMatching();
+
+	// FAnimNode_AssetPlayerBase interface
+	virtual float GetCurrentAssetTime();
+	virtual float GetCurrentAssetLength();
+	// End of FAnimNode_AssetPlayerBase interface
+
+	// FAnimNode_Base interface
+	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
+	virtual void CacheBones_AnyThread(const FAnimationCacheBonesContext& Context) override;
+	virtual void UpdateAssetPlayer(const FAnimationUpdateContext& Context) override;
+	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual void OverrideAsset(UAnimationAsset* NewAsset) override;
+	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
+	// End of FAnimNode_Base interface
+
+	// FAnimNode_AssetPlayerBase Interface
+	virtual UAnimationAsset* GetAnimAsset() { return Sequence; }
+	// End of FAnimNode_AssetPlayerBase Interface
+
+	/** Bake the angle curve of the current sequence, returns false if the sequence has no usable curve */
+	bool BakeAngleCurve();
+
+private:
+	float GetAngleCurveTime();
+
+private:
+	/** Prepared curve shared through FDistanceCurveRegistry */
+	FDistanceCurveHandle CurveHandle;
+};
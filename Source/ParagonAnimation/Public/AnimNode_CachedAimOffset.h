@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Animation/AnimNodeBase.h"
+#include "Animation/AnimSequence.h"
+#include "AimOffsetPoseCache.h"
+#include "AnimNode_CachedAimOffset.generated.h"
+
+/** The nine single frame mesh space additive poses of an aim offset, like the Idle_AO_* sequences */
+USTRUCT(BlueprintType)
+struct PARAGONANIMATION_API FAimOffsetPoseSet
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequence* LeftDown;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequence* CenterDown;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequence* RightDown;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequence* LeftCenter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequence* CenterCenter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequence* RightCenter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequence* LeftUp;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequence* CenterUp;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequence* RightUp;
+
+public:
+	FAimOffsetPoseSet();
+
+	/** The poses in EAimOffsetPose order */
+	void GetPoses(UAnimSequence** OutPoses) const;
+
+	bool operator==(const FAimOffsetPoseSet& Other) const;
+	bool operator!=(const FAimOffsetPoseSet& Other) const { return !(*this == Other); }
+};
+
+/**
+ * Aim offset that blends the mesh space additive poses extracted once per skeleton by FAimOffsetPoseCache.
+ * Each update bilinearly blends the four cached poses around Yaw and Pitch, no sequence is sampled at runtime.
+ */
+USTRUCT()
+struct PARAGONANIMATION_API FAnimNode_CachedAimOffset : public FAnimNode_Base
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Links)
+	FPoseLink BasePose;
+
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (NeverAsPin))
+	FAimOffsetPoseSet Poses;
+
+	/** Yaw in degrees, usually UParagonAnimInstance::AimYaw */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	float Yaw;
+
+	/** Pitch in degrees, usually UParagonAnimInstance::AimPitch */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	float Pitch;
+
+	/** Yaw of the left and right poses */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault, ClampMin = "1.0"))
+	float YawRange;
+
+	/** Pitch of the up and down poses */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault, ClampMin = "1.0"))
+	float PitchRange;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault, ClampMin = "0.0", ClampMax = "1.0"))
+	float Alpha;
+
+public:
+	FAnimNode_CachedAimOffset();
+
+	// FAnimNode_Base interface
+	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
+	virtual void CacheBones_AnyThread(const FAnimationCacheBonesContext& Context) override;
+	virtual void Update_AnyThread(const FAnimationUpdateContext& Context) override;
+	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
+	// End of FAnimNode_Base interface
+
+private:
+	void UpdatePoseData(const USkeleton* Skeleton);
+
+private:
+	/** Shared poses of Poses for the skeleton of the instance */
+	FAimOffsetPoseDataPtr PoseData;
+	FAimOffsetPoseSet ResolvedPoses;
+};
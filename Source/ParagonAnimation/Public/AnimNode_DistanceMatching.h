@@ -4,9 +4,34 @@
 #include "UObject/ObjectMacros.h"
 #include "Animation/AnimNode_AssetPlayerBase.h"
 #include "Animation/AnimSequenceBase.h"
-#include "Animation/AnimSequenceDecompressionContext.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Animation/CustomAttributesRuntime.h"
+#include "BonePose.h"
+#include "DistanceCurveTable.h"
+#include "DistanceCurveRegistry.h"
 #include "AnimNode_DistanceMatching.generated.h"
 
+/** How often a distance matching node looks up its curve at one LOD */
+USTRUCT(BlueprintType)
+struct PARAGONANIMATION_API FDistanceMatchingLODSettings
+{
+	GENERATED_BODY()
+public:
+	/** Look the distance curve up every N updates, the time is extrapolated from the last two lookups in between */
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (ClampMin = "1"))
+	int32 CurveUpdateInterval;
+
+	/** Snap the evaluated time to multiples of this step so the cached pose is reused, 0 evaluates the exact time */
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (ClampMin = "0.0"))
+	float TimeQuantization;
+
+	/** Bones that are not decompressed at this LOD and keep the reference pose, together with their children, e.g. fingers and twist bones */
+	UPROPERTY(EditAnywhere, Category = Settings)
+	TArray<FName> ExcludedBones;
+
+	FDistanceMatchingLODSettings();
+};
+
 USTRUCT()
 struct PARAGONANIMATION_API FAnimNode_DistanceMatching : public FAnimNode_AssetPlayerBase
 {
@@ -15,12 +40,48 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
 	UAnimSequenceBase* Sequence;
 
+	/**
+	 * Streamed in through UParagonAnimStreamingSubsystem and played instead of Sequence once resident.
+	 * Sequence plays while it loads, or the reference pose if Sequence is empty. Put it in the hero's UParagonLocomotionClipSet to stream it in ahead of time
+	 */
+	UPROPERTY(EditAnywhere, Category = Streaming, meta = (NeverAsPin))
+	TSoftObjectPtr<UAnimSequenceBase> StreamedSequence;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
 	FName CurveName;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
 	float Distance;
 
+	/** Number of uniformly spaced samples used when baking the distance curve during compilation */
+	UPROPERTY(EditAnywhere, Category = Settings, AdvancedDisplay, meta = (NeverAsPin, ClampMin = "2", ClampMax = "4096"))
+	int32 BakedCurveSamples;
+
+	/** Reuse the last evaluated pose while the sequence, time and required bones are unchanged, e.g. once a stop has finished */
+	UPROPERTY(EditAnywhere, Category = Settings, AdvancedDisplay, meta = (NeverAsPin))
+	bool bCachePose;
+
+	/**
+	 * Settings per mesh LOD, the last entry also applies to all higher LODs. Empty looks the curve up on every update.
+	 * Intervals count actual updates, so they stack with the mesh's update rate optimization.
+	 */
+	UPROPERTY(EditAnywhere, Category = LOD, meta = (NeverAsPin))
+	TArray<FDistanceMatchingLODSettings> LODSettings;
+
+	/** Distance curve of BakedSequence baked during compilation */
+	UPROPERTY()
+	FDistanceCurveTable BakedCurve;
+
+	UPROPERTY()
+	UAnimSequenceBase* BakedSequence;
+
+	UPROPERTY()
+	FName BakedCurveName;
+
+	/** BakedCurve belongs to StreamedSequence, which BakedSequence must not reference */
+	UPROPERTY()
+	bool bBakedStreamedSequence;
+
 public:
 	FAnimNode_DistanceMatching();
 
@@ -30,6 +91,8 @@ public:
 	// End of FAnimNode_AssetPlayerBase interface
 
 	// FAnimNode_Base interface
+	virtual bool HasPreUpdate() const override { return !StreamedSequence.IsNull(); }
+	virtual void PreUpdate(const UAnimInstance* InAnimInstance) override;
 	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
 	virtual void CacheBones_AnyThread(const FAnimationCacheBonesContext& Context) override;
 	virtual void UpdateAssetPlayer(const FAnimationUpdateContext& Context) override;
@@ -39,6 +102,64 @@ public:
 	// End of FAnimNode_Base interface
 
 	// FAnimNode_AssetPlayerBase Interface
-	virtual UAnimationAsset* GetAnimAsset() { return Sequence; }
+	virtual UAnimationAsset* GetAnimAsset() { return GetPlayedSequence(); }
 	// End of FAnimNode_AssetPlayerBase Interface
+
+	/** Bake the distance curve of the current sequence, returns false if the sequence has no usable curve */
+	bool BakeDistanceCurve();
+
+private:
+	/** The streamed clip while it is resident, Sequence otherwise */
+	UAnimSequenceBase* GetPlayedSequence() const { return ResolvedStreamedSequence ? ResolvedStreamedSequence : Sequence; }
+
+	float GetDistanceCurveTime();
+	float GetDistanceMatchedPlayRate(const FAnimationUpdateContext& Context, const FDistanceMatchingLODSettings* LOD);
+	const FDistanceMatchingLODSettings* GetLODSettings(int32 LODLevel) const;
+
+	/** Rebuild the reduced bone set when the required bones or the LOD changed */
+	void UpdateRequiredBones(const FAnimInstanceProxy& Proxy);
+	void EvaluateReducedPose(FPoseContext& Output, const FAnimExtractContext& ExtractContext);
+
+private:
+	/**
+	 * StreamedSequence if it is resident this frame, resolved on the game thread by PreUpdate. Not a reference, eviction
+	 * happens after the frame's animation finished and PreUpdate resolves it again before the next update
+	 */
+	UAnimSequenceBase* ResolvedStreamedSequence;
+
+	/** Prepared curve shared through FDistanceCurveRegistry */
+	FDistanceCurveHandle CurveHandle;
+
+	/** Last looked up curve time and its rate of change, for extrapolating between lookups */
+	const UAnimSequenceBase* LookupSequence;
+	float LookupTime;
+	float LookupRate;
+	float TimeSinceLookup;
+	int32 UpdatesUntilLookup;
+
+	/** Step InternalTimeAccumulator is snapped to for evaluation at the current LOD */
+	float TimeQuantization;
+
+	/** Required bones without the excluded bones of the current LOD, and the output bone of each of them */
+	FBoneContainer ReducedBones;
+	TArray<FCompactPoseBoneIndex> ReducedToOutput;
+
+	/** Reduced compact index of each kept bone by its mesh index, to move the custom attributes onto the output bones */
+	TMap<int32, int32> ReducedBoneMap;
+	FHeapCustomAttributes ReducedAttributes;
+	uint16 BonesSerialNumber;
+	int32 BonesLODLevel;
+	bool bReduceBones;
+
+	/** Last evaluated pose and the key it was evaluated for */
+	FCompactHeapPose CachedPose;
+	FBlendedHeapCurve CachedCurve;
+	FHeapCustomAttributes CachedAttributes;
+	const UAnimSequenceBase* CachedSequence;
+	float CachedTime;
+	uint16 CachedRequiredBonesSerialNumber;
+	bool bCachedRootMotion;
+	bool bHasCachedPose;
+	uint32 NumCacheHits;
+	uint32 NumCacheMisses;
 };
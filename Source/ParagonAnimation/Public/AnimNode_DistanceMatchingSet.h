@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Animation/AnimNode_AssetPlayerBase.h"
+#include "Animation/AnimSequenceBase.h"
+#include "DistanceMatchedClipStack.h"
+#include "ParagonLocomotion.h"
+#include "AnimNode_DistanceMatchingSet.generated.h"
+
+/** One clip per cardinal direction */
+USTRUCT(BlueprintType)
+struct PARAGONANIMATION_API FDistanceMatchingDirectionalClips
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequenceBase* North;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequenceBase* East;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequenceBase* South;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings)
+	UAnimSequenceBase* West;
+
+public:
+	FDistanceMatchingDirectionalClips();
+
+	UAnimSequenceBase* Get(EAnimCardinalDirection Direction) const;
+
+	void GetAll(TArray<UAnimSequenceBase*>& OutSequences) const;
+};
+
+/**
+ * Distance matches the start and stop clips of all four cardinal directions in a single node.
+ * Selects the clip from Phase and Direction and cross fades to it when the selection changes, interrupted fades included.
+ */
+USTRUCT()
+struct PARAGONANIMATION_API FAnimNode_DistanceMatchingSet : public FAnimNode_AssetPlayerBase
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
+	FDistanceMatchingDirectionalClips StartClips;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
+	FDistanceMatchingDirectionalClips StopClips;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
+	FName CurveName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	EDistanceMatchingPhase Phase;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	EAnimCardinalDirection Direction;
+
+	/** Distance fed to start clips, usually UParagonAnimInstance::DistanceMachingStart */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	float StartDistance;
+
+	/** Distance fed to stop clips, usually UParagonAnimInstance::DistanceMachingStop */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	float StopDistance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault, ClampMin = "0.0"))
+	float BlendTime;
+
+	/** Number of uniformly spaced samples the distance curves of the clips are resampled to */
+	UPROPERTY(EditAnywhere, Category = Settings, AdvancedDisplay, meta = (NeverAsPin, ClampMin = "2", ClampMax = "4096"))
+	int32 CurveSamples;
+
+public:
+	FAnimNode_DistanceMatchingSet();
+
+	// FAnimNode_AssetPlayerBase interface
+	virtual float GetCurrentAssetTime();
+	virtual float GetCurrentAssetLength();
+	// End of FAnimNode_AssetPlayerBase interface
+
+	// FAnimNode_Base interface
+	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
+	virtual void CacheBones_AnyThread(const FAnimationCacheBonesContext& Context) override;
+	virtual void UpdateAssetPlayer(const FAnimationUpdateContext& Context) override;
+	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
+	// End of FAnimNode_Base interface
+
+	// FAnimNode_AssetPlayerBase Interface
+	virtual UAnimationAsset* GetAnimAsset() { return ClipStack.GetActive().Sequence; }
+	// End of FAnimNode_AssetPlayerBase Interface
+
+	UAnimSequenceBase* GetSelectedSequence() const;
+
+private:
+	FDistanceMatchedClipStack ClipStack;
+};
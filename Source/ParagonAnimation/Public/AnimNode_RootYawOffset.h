@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Animation/AnimNodeBase.h"
+#include "AnimNode_RootYawOffset.generated.h"
+
+/**
+ * Rotates the root bone around the component up axis.
+ * Lets the cardinal direction mesh rotation be applied in the anim graph instead of rotating the mesh component.
+ */
+USTRUCT()
+struct PARAGONANIMATION_API FAnimNode_RootYawOffset : public FAnimNode_Base
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Links)
+	FPoseLink BasePose;
+
+	/** Yaw in degrees, usually UParagonAnimInstance::RootYawOffset */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	float Yaw;
+
+public:
+	FAnimNode_RootYawOffset();
+
+	// FAnimNode_Base interface
+	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
+	virtual void CacheBones_AnyThread(const FAnimationCacheBonesContext& Context) override;
+	virtual void Update_AnyThread(const FAnimationUpdateContext& Context) override;
+	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
+	// End of FAnimNode_Base interface
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Animation/AnimNode_AssetPlayerBase.h"
+#include "Animation/AnimSequence.h"
+#include "DistanceMatchedClipStack.h"
+#include "LocomotionFeatureDatabase.h"
+#include "AnimNode_StartStopMatching.generated.h"
+
+struct FParagonAnimInstanceProxy;
+
+/**
+ * Picks the start or stop clip, and the time to enter it at, that best matches the predicted movement of the character.
+ * Any number of clips can be used, e.g. the Jog_*_Start, Jog_*_Stop, circle strafe and slope variations, instead of one per
+ * cardinal direction. The choice is a nearest neighbour search in a feature database baked during compilation, made when
+ * UParagonAnimInstance detects a start or a stop, after which the clip is distance matched like FAnimNode_DistanceMatchingSet.
+ * Only works under a UParagonAnimInstance, whose proxy provides the movement and the transitions.
+ */
+USTRUCT()
+struct PARAGONANIMATION_API FAnimNode_StartStopMatching : public FAnimNode_AssetPlayerBase
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, Category = Settings)
+	TArray<UAnimSequence*> StartClips;
+
+	UPROPERTY(EditAnywhere, Category = Settings)
+	TArray<UAnimSequence*> StopClips;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault))
+	FName CurveName;
+
+	/** Distance fed to start clips, usually UParagonAnimInstance::DistanceMachingStart */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	float StartDistance;
+
+	/** Distance fed to stop clips, usually UParagonAnimInstance::DistanceMachingStop */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinShownByDefault))
+	float StopDistance;
+
+	/** Speed the predicted start trajectory accelerates to */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault, ClampMin = "0.0"))
+	float MaxSpeed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Settings, meta = (PinHiddenByDefault, ClampMin = "0.0"))
+	float BlendTime;
+
+	/** Number of uniformly spaced samples the distance curves of the clips are resampled to */
+	UPROPERTY(EditAnywhere, Category = Settings, AdvancedDisplay, meta = (NeverAsPin, ClampMin = "2", ClampMax = "4096"))
+	int32 CurveSamples;
+
+	UPROPERTY(EditAnywhere, Category = Matching, meta = (NeverAsPin))
+	FLocomotionFeatureSettings FeatureSettings;
+
+	/** Features of StartClips baked during compilation */
+	UPROPERTY()
+	FLocomotionFeatureDatabase StartDatabase;
+
+	/** Features of StopClips baked during compilation */
+	UPROPERTY()
+	FLocomotionFeatureDatabase StopDatabase;
+
+public:
+	FAnimNode_StartStopMatching();
+
+	// FAnimNode_AssetPlayerBase interface
+	virtual float GetCurrentAssetTime();
+	virtual float GetCurrentAssetLength();
+	// End of FAnimNode_AssetPlayerBase interface
+
+	// FAnimNode_Base interface
+	virtual void Initialize_AnyThread(const FAnimationInitializeContext& Context) override;
+	virtual void CacheBones_AnyThread(const FAnimationCacheBonesContext& Context) override;
+	virtual void UpdateAssetPlayer(const FAnimationUpdateContext& Context) override;
+	virtual void Evaluate_AnyThread(FPoseContext& Output) override;
+	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
+	virtual bool HasPreUpdate() const override { return StartDatabase.bHasFootPhase || StopDatabase.bHasFootPhase; }
+	virtual void PreUpdate(const UAnimInstance* InAnimInstance) override;
+	// End of FAnimNode_Base interface
+
+	// FAnimNode_AssetPlayerBase Interface
+	virtual UAnimationAsset* GetAnimAsset() { return ClipStack.GetActive().Sequence; }
+	// End of FAnimNode_AssetPlayerBase Interface
+
+#if WITH_EDITOR
+	/** Bake the feature databases of the start and stop clips */
+	void BakeFeatureDatabases();
+#endif // WITH_EDITOR
+
+private:
+	/** Search the database of Phase and blend to the best entry, MeshRotation is the frame the clips play in this update */
+	void SelectClip(const FParagonAnimInstanceProxy& ParagonProxy, const FQuat& MeshRotation, EDistanceMatchingPhase SelectPhase);
+
+private:
+	FDistanceMatchedClipStack ClipStack;
+
+	/** Select a clip on the next update, set when the node becomes relevant */
+	bool bSelectPending;
+
+	/** Left foot minus right foot in component space, read on the game thread by PreUpdate */
+	FVector2D FootSeparation;
+
+	/** Entries compared by the last selection, for the debug display */
+	int32 LastComparisons;
+};
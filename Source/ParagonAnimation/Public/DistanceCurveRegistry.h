@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SharedAssetCache.h"
+#include "DistanceCurveTable.h"
+
+class UAnimSequenceBase;
+
+/** Prepared distance curve of one (sequence, curve name, sample count) triple, shared by every node that plays it */
+struct PARAGONANIMATION_API FDistanceCurveData : public FSharedAssetCacheEntry
+{
+	FDistanceCurveTable Table;
+};
+
+typedef TSharedPtr<const FDistanceCurveData, ESPMode::ThreadSafe> FDistanceCurveDataPtr;
+
+/** A node's reference to one registry entry, re-resolved when the sequence or curve changes or the entry goes stale */
+struct PARAGONANIMATION_API FDistanceCurveHandle
+{
+	FDistanceCurveHandle();
+
+	/** Point the handle at the entry of Sequence, CurveName and NumSamples, returns true if it had to resolve */
+	bool Update(const UAnimSequenceBase* InSequence, FName InCurveName, const FDistanceCurveTable* BakedTable, int32 NumSamples);
+
+	/** Distance to time, falls back to searching the curve keys if the curve could not be prepared */
+	float Evaluate(float Distance) const;
+
+	bool HasData() const { return CurveData.IsValid(); }
+
+	void Reset();
+
+private:
+	FDistanceCurveDataPtr CurveData;
+	const UAnimSequenceBase* Sequence;
+	FName CurveName;
+	int32 NumSamples;
+};
+
+/** Key of the FDistanceCurveRegistry entries */
+struct PARAGONANIMATION_API FDistanceCurveKey
+{
+	FObjectKey Sequence;
+	FName CurveName;
+	int32 NumSamples = 0;
+
+	bool Uses(const FObjectKey& Object) const { return Sequence == Object; }
+	bool IsStale() const { return Sequence.ResolveObjectPtr() == nullptr; }
+
+	bool operator==(const FDistanceCurveKey& Other) const { return Sequence == Other.Sequence && CurveName == Other.CurveName && NumSamples == Other.NumSamples; }
+	friend uint32 GetTypeHash(const FDistanceCurveKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.Sequence), GetTypeHash(Key.CurveName)), GetTypeHash(Key.NumSamples));
+	}
+};
+
+/**
+ * Process wide cache of prepared distance curves.
+ * Curves are resolved once per (sequence, curve name, sample count) and shared across all anim instances, lookups are safe from worker threads.
+ */
+class PARAGONANIMATION_API FDistanceCurveRegistry : public TSharedAssetCache<FDistanceCurveKey, FDistanceCurveData>
+{
+public:
+	static FDistanceCurveRegistry& Get();
+
+	/**
+	 * Find the prepared curve, preparing it on first use.
+	 * BakedTable is adopted instead of resampling the curve when it was baked from the same sequence with NumSamples samples.
+	 */
+	FDistanceCurveDataPtr FindOrAdd(const UAnimSequenceBase* Sequence, FName CurveName, const FDistanceCurveTable* BakedTable, int32 NumSamples);
+};
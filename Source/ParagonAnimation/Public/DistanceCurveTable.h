@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "ParagonCore/DistanceCurve.h"
+#include "DistanceCurveTable.generated.h"
+
+class UAnimSequenceBase;
+struct FFloatCurve;
+
+/**
+ * Distance curve resampled at uniformly spaced distances so that a lookup is a single index and lerp.
+ * Only the clip times are stored, the distance of sample i is MinDistance + i / InvDistanceStep.
+ * Times are quantized to 16 bits over the range of the curve, i.e. TimeOffset + QuantizedTimes[i] * TimeScale.
+ */
+USTRUCT()
+struct PARAGONANIMATION_API FDistanceCurveTable
+{
+	GENERATED_BODY()
+public:
+	/** Samples used by nodes that do not bake their curves, and the default of those that do */
+	enum { DefaultNumSamples = 128 };
+
+	UPROPERTY()
+	TArray<uint16> QuantizedTimes;
+
+	UPROPERTY()
+	float TimeOffset;
+
+	UPROPERTY()
+	float TimeScale;
+
+	UPROPERTY()
+	float MinDistance;
+
+	UPROPERTY()
+	float MaxDistance;
+
+	UPROPERTY()
+	float InvDistanceStep;
+
+	/** Whether the source curve passed Validate, checked once when building so lookups never have to */
+	UPROPERTY()
+	bool bValidCurve;
+
+public:
+	FDistanceCurveTable();
+
+	bool IsValid() const { return QuantizedTimes.Num() >= 2; }
+
+	void Reset();
+
+	/** Resample the distance curve into NumSamples uniformly spaced entries */
+	void Build(const FFloatCurve& DistanceCurve, int32 NumSamples);
+
+	/** Constant time distance to time lookup, extrapolates linearly outside of the baked range like the curve search does */
+	float Evaluate(float Distance) const
+	{
+		ParagonCore::FTimeQuantization Quantization;
+		Quantization.TimeOffset = TimeOffset;
+		Quantization.TimeScale = TimeScale;
+		return ParagonCore::EvaluateQuantizedTable(QuantizedTimes.GetData(), QuantizedTimes.Num(), Quantization, MinDistance, InvDistanceStep, Distance);
+	}
+
+	/** Bytes of the table including its allocation */
+	SIZE_T GetTotalSize() const { return sizeof(FDistanceCurveTable) + QuantizedTimes.GetAllocatedSize(); }
+
+	/** Find a float curve on the sequence by its display name */
+	static const FFloatCurve* FindCurve(const UAnimSequenceBase* Sequence, const FName& CurveName);
+
+	/** Binary search the raw curve keys, used for baking and for sequences that were not baked */
+	static float EvaluateCurve(const FFloatCurve& DistanceCurve, float Distance);
+
+	/**
+	 * Check that the key values strictly increase, i.e. are sorted and unique, so every distance maps to a single time.
+	 * OutError, if given, lists the times of the offending keys.
+	 */
+	static bool Validate(const FFloatCurve& DistanceCurve, FString* OutError = nullptr);
+};
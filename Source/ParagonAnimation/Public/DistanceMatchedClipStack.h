@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Animation/AnimSequenceBase.h"
+#include "DistanceCurveRegistry.h"
+#include "DistanceMatchedClipStack.generated.h"
+
+struct FPoseContext;
+
+UENUM(BlueprintType)
+enum class EDistanceMatchingPhase : uint8
+{
+	Start UMETA(DisplayName = "Start"),
+	Stop UMETA(DisplayName = "Stop"),
+};
+
+/**
+ * Distance matched clips cross fading into each other, played by FAnimNode_DistanceMatchingSet and FAnimNode_StartStopMatching.
+ * The active clip is on top, the ones it interrupted fade out together below it from the weights they had reached.
+ */
+class PARAGONANIMATION_API FDistanceMatchedClipStack
+{
+public:
+	struct FPlayer
+	{
+		UAnimSequenceBase* Sequence = nullptr;
+		EDistanceMatchingPhase Phase = EDistanceMatchingPhase::Start;
+		float Time = 0.f;
+		float Weight = 0.f;
+
+		/** Distance the clip had covered at its entry time, added to the start distance so entering late does not jump back */
+		float DistanceOffset = 0.f;
+
+		FDistanceCurveHandle CurveHandle;
+	};
+
+	FDistanceMatchedClipStack();
+
+	/** Drop all players and play Sequence at full weight */
+	void Reset(UAnimSequenceBase* Sequence = nullptr, EDistanceMatchingPhase Phase = EDistanceMatchingPhase::Start);
+
+	/** Add a player on top of the stack to blend in, dropping the weakest one if it is full. An empty stack is played at once */
+	FPlayer& Push(UAnimSequenceBase* Sequence, EDistanceMatchingPhase Phase);
+
+	/** Blend the active player in over BlendTime and move every player to the time its distance matches */
+	void Update(float DeltaTime, float BlendTime, float StartDistance, float StopDistance, FName CurveName, int32 CurveSamples);
+
+	void Evaluate(FPoseContext& Output) const;
+
+	/** Append the sequence, time and weight of every player, newest first */
+	void GatherDebugData(FString& DebugLine) const;
+
+	const FPlayer& GetActive() const { return Players[NumPlayers - 1]; }
+
+private:
+	/** Blend the first NumBlended players of the stack by their weights */
+	void EvaluatePlayers(int32 NumBlended, FPoseContext& Output) const;
+
+private:
+	enum { MaxPlayers = 3 };
+
+	/** The active clip on top and the ones it is blending out of below, oldest first */
+	FPlayer Players[MaxPlayers];
+	int32 NumPlayers;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "LocomotionFeatureDatabase.generated.h"
+
+class UAnimSequence;
+
+/** What the features of a clip entry are sampled from, and how much each group counts in the match */
+USTRUCT(BlueprintType)
+struct PARAGONANIMATION_API FLocomotionFeatureSettings
+{
+	GENERATED_BODY()
+public:
+	/** Seconds ahead of the entry time of the first trajectory sample */
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (ClampMin = "0.0"))
+	float NearTrajectoryTime;
+
+	/** Seconds ahead of the entry time of the second trajectory sample of start clips, stop clips use the end of the clip */
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (ClampMin = "0.0"))
+	float FarTrajectoryTime;
+
+	/** Entries are sampled from the first EntryWindow seconds of every clip */
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (ClampMin = "0.0"))
+	float EntryWindow;
+
+	UPROPERTY(EditAnywhere, Category = Settings, meta = (ClampMin = "0.001"))
+	float SampleInterval;
+
+	/** Foot phase is the offset of the left foot from the right foot in component space, skipped if either bone is missing */
+	UPROPERTY(EditAnywhere, Category = Settings)
+	FName LeftFootBone;
+
+	UPROPERTY(EditAnywhere, Category = Settings)
+	FName RightFootBone;
+
+	UPROPERTY(EditAnywhere, Category = Weights, meta = (ClampMin = "0.0"))
+	float TrajectoryWeight;
+
+	UPROPERTY(EditAnywhere, Category = Weights, meta = (ClampMin = "0.0"))
+	float VelocityWeight;
+
+	UPROPERTY(EditAnywhere, Category = Weights, meta = (ClampMin = "0.0"))
+	float FootPhaseWeight;
+
+public:
+	FLocomotionFeatureSettings();
+};
+
+/** Features of the character when selecting a clip, or of a clip at one entry time, all in component space */
+struct PARAGONANIMATION_API FLocomotionFeatureQuery
+{
+	FVector2D NearTrajectory;
+	FVector2D FarTrajectory;
+	FVector2D Velocity;
+	FVector2D FootSeparation;
+
+	FLocomotionFeatureQuery();
+};
+
+/**
+ * Entries (clip, entry time) of a set of start or stop clips and their weighted features, baked during compilation.
+ * The features are stored as an implicit kd-tree, see ParagonCore::BuildFeatureIndex, so selecting a clip compares
+ * against a logarithmic number of entries instead of every sample of every clip.
+ */
+USTRUCT()
+struct PARAGONANIMATION_API FLocomotionFeatureDatabase
+{
+	GENERATED_BODY()
+public:
+	enum { NumDimensions = 8 };
+
+	/** NumDimensions weighted features per entry, in kd-tree order */
+	UPROPERTY()
+	TArray<float> Features;
+
+	UPROPERTY()
+	TArray<uint8> SplitDimensions;
+
+	/** Index into the clip array the database was built from, per entry */
+	UPROPERTY()
+	TArray<int32> ClipIndices;
+
+	UPROPERTY()
+	TArray<float> ClipTimes;
+
+	/** The settings the features were sampled and weighted with, queries must use the same */
+	UPROPERTY()
+	FLocomotionFeatureSettings Settings;
+
+	/** Every clip had both foot bones */
+	UPROPERTY()
+	bool bHasFootPhase;
+
+public:
+	FLocomotionFeatureDatabase();
+
+	int32 Num() const { return ClipIndices.Num(); }
+
+	bool IsValid() const { return Num() > 0 && Features.Num() == Num() * NumDimensions && SplitDimensions.Num() == Num(); }
+
+	void Reset();
+
+#if WITH_EDITOR
+	/**
+	 * Sample the entries of Clips from their raw root and foot tracks.
+	 * Stop clips measure the far trajectory to the end of the clip, where the character comes to rest.
+	 */
+	void Build(const TArray<UAnimSequence*>& Clips, bool bStopClips, const FLocomotionFeatureSettings& InSettings);
+#endif // WITH_EDITOR
+
+	/** Find the entry closest to Query, returns false if the database is empty. OutComparisons counts the entries visited */
+	bool FindNearest(const FLocomotionFeatureQuery& Query, int32& OutClipIndex, float& OutClipTime, int32* OutComparisons = nullptr) const;
+
+	/** Bytes of the database including its allocations */
+	SIZE_T GetTotalSize() const;
+
+private:
+	void WriteFeatures(const FLocomotionFeatureQuery& Query, float* OutFeatures) const;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "ParagonAnimBudgetSubsystem.generated.h"
+
+class UParagonAnimInstance;
+
+/** What the animation budget did in the last frame */
+USTRUCT(BlueprintType)
+struct PARAGONANIMATION_API FParagonAnimBudgetTelemetry
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(BlueprintReadOnly, Category = Budget)
+	float BudgetMs = 0.f;
+
+	/** Estimated cost of the updates granted this frame, averaged over their tick rates */
+	UPROPERTY(BlueprintReadOnly, Category = Budget)
+	float UsedMs = 0.f;
+
+	/** How far UsedMs exceeds the budget because even MaxTickRate for every character does not fit it */
+	UPROPERTY(BlueprintReadOnly, Category = Budget)
+	float OverflowMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = Budget)
+	int32 NumFullRate = 0;
+
+	/** Characters updated at a reduced rate and interpolated in between */
+	UPROPERTY(BlueprintReadOnly, Category = Budget)
+	int32 NumDeferred = 0;
+};
+
+/**
+ * Keeps the animation update of all registered Paragon characters within Paragon.AnimBudget.BudgetMs.
+ * Characters are ranked by significance, from distance to the closest view, visibility and UParagonAnimInstance::SignificanceBias.
+ * The most significant ones update every frame as long as their measured cost fits the budget, the rest run at a reduced
+ * rate through the mesh's external tick rate control and are interpolated in between, so that the cost of every
+ * character divided by its tick rate sums up to at most the budget.
+ */
+UCLASS()
+class PARAGONANIMATION_API UParagonAnimBudgetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	// USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End of USubsystem interface
+
+	void Register(UParagonAnimInstance* AnimInstance);
+	void Unregister(UParagonAnimInstance* AnimInstance);
+
+	int32 GetNumRegistered() const { return Entries.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = Budget)
+	const FParagonAnimBudgetTelemetry& GetTelemetry() const { return Telemetry; }
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<UParagonAnimInstance> AnimInstance;
+
+		/** Moving average of the measured update and evaluation cost */
+		float CostMs = 0.f;
+		float Significance = 0.f;
+
+		/** The mesh's own setting, restored when unregistering */
+		bool bPreviousUpdateRateOptimizations = false;
+	};
+
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+	/** Higher is more important */
+	float CalculateSignificance(const UParagonAnimInstance& AnimInstance, const TArray<FVector, TInlineAllocator<4>>& ViewLocations) const;
+
+private:
+	TArray<FEntry> Entries;
+	FParagonAnimBudgetTelemetry Telemetry;
+
+	FDelegateHandle PreActorTickHandle;
+};
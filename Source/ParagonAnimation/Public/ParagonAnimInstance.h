@@ -2,15 +2,86 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "ParagonLocomotion.h"
+#include "ParagonLocomotionRecording.h"
 #include "ParagonAnimInstance.generated.h"
 
-UENUM(BlueprintType)
-enum class EAnimCardinalDirection : uint8
+class UParagonAnimInstance;
+class UParagonLocomotionClipSet;
+
+/**
+ * Snapshots the movement inputs on the game thread and computes the locomotion parameters on the animation worker thread.
+ * Only the mesh rotation is written back on the game thread.
+ */
+USTRUCT()
+struct PARAGONANIMATION_API FParagonAnimInstanceProxy : public FAnimInstanceProxy
 {
-	North UMETA(DisplayName = "North"),
-	East UMETA(DisplayName = "East"),
-	South UMETA(DisplayName = "South"),
-	West UMETA(DisplayName = "West"),
+	GENERATED_BODY()
+public:
+	FParagonAnimInstanceProxy();
+	FParagonAnimInstanceProxy(UAnimInstance* InAnimInstance);
+
+	/** The proxy of the instance, if the instance is a UParagonAnimInstance */
+	static FParagonAnimInstanceProxy* FromProxy(FAnimInstanceProxy* Proxy);
+	static const FParagonAnimInstanceProxy* FromProxy(const FAnimInstanceProxy* Proxy);
+
+	/** Reset the rotation history from the current pawn, game thread only */
+	void InitializeLocomotion(UParagonAnimInstance* InAnimInstance);
+
+	const FParagonLocomotionState& GetLocomotionState() const { return State; }
+
+	const FParagonLocomotionFixedStep& GetLocomotionFixedStep() const { return FixedStep; }
+
+	/** Movement inputs of the last update, not valid before the first one */
+	const FParagonLocomotionInput& GetLocomotionInput() const { return Input; }
+
+	/** The cardinal direction rotation is applied to the root bone instead of the mesh component */
+	bool IsRotatingRootBone() const { return bRotateRootBone; }
+
+	/** Hand over the state computed by UParagonLocomotionSubsystem and the inputs it was computed from, game thread only */
+	void SetBatchedLocomotionState(const FParagonLocomotionState& InState, const FParagonLocomotionInput& InInput) { State = InState; Input = InInput; }
+
+	/** Turn the mesh towards the actor by the yaw a turn in place clip covered this update, called by the anim graph */
+	void ConsumeTurnYaw(float TurnedYaw);
+
+	/** Yaw turned since the last call, for UParagonLocomotionSubsystem to apply to the batched state, game thread only */
+	float ConsumePendingTurnYaw() { const float Yaw = PendingTurnYaw; PendingTurnYaw = 0.f; return Yaw; }
+
+	/** Cycles the updates and evaluations since the last call spent in this proxy, game thread only */
+	uint32 ConsumeAnimationCycles() { const uint32 Cycles = AnimationCycles; AnimationCycles = 0; return Cycles; }
+
+protected:
+	// FAnimInstanceProxy interface
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+	virtual void UpdateAnimationNode(const FAnimationUpdateContext& InContext) override;
+	virtual void EvaluateAnimationNode(FPoseContext& Output) override;
+	virtual void PostUpdate(UAnimInstance* InAnimInstance) const override;
+	// End of FAnimInstanceProxy interface
+
+private:
+	FParagonLocomotionInput Input;
+	FParagonLocomotionSettings Settings;
+	FParagonLocomotionState State;
+	FParagonLocomotionFixedStep FixedStep;
+	bool bDrawDebug;
+	bool bRotateRootBone;
+
+	/** State is computed by UParagonLocomotionSubsystem instead of Update */
+	bool bBatched;
+
+	/** Yaw turned by the anim graph since UParagonLocomotionSubsystem last gathered the batched inputs */
+	float PendingTurnYaw;
+
+	/** The anim graph turned the mesh this update, PostUpdate has to rotate the mesh component even though it is idle */
+	bool bTurnedThisUpdate;
+
+	/** Time spent in Update and the anim graph update and evaluation, read by UParagonAnimBudgetSubsystem */
+	uint32 AnimationCycles;
+
+	/** Set while UParagonAnimInstance::StartRecording is active, the last reference closes the file */
+	TSharedPtr<FParagonLocomotionRecorder, ESPMode::ThreadSafe> Recorder;
 };
 
 UCLASS()
@@ -55,16 +126,87 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animation)
 	float DistanceMachingScaling;
 
+	/** Yaw to feed a Root Yaw Offset node when bRotateRootBone is set */
+	UPROPERTY(BlueprintReadOnly, Category = Animation)
+	float RootYawOffset;
+
+	/** Yaw the mesh still has to turn to face the actor, to feed an Angle Matching node */
+	UPROPERTY(BlueprintReadOnly, Category = Animation)
+	float RemainingTurnYaw;
+
+	/** Leave the mesh component alone and apply the cardinal direction rotation to the root bone through RootYawOffset */
+	UPROPERTY(EditDefaultsOnly, Category = Animation)
+	bool bRotateRootBone;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animation)
 	bool bDrawDebug;
-	
+
+	/** Let UParagonLocomotionSubsystem update the locomotion parameters together with all other opted in characters, one frame behind */
+	UPROPERTY(EditDefaultsOnly, Category = Optimization)
+	bool bUseBatchedUpdate;
+
+	/** Highest mesh LOD that simulates braking for the stop location, higher LODs use a constant deceleration estimate. Negative simulates at all LODs */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Optimization)
+	int32 StopPredictionMaxLOD;
+
+	/** Update the locomotion parameters this many times per second and interpolate in between, 0 updates every tick. Not used by the batched update */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Optimization, meta = (ClampMin = "0.0"))
+	float FixedUpdateRate;
+
+	/** Lowest mesh LOD that uses FixedUpdateRate, closer characters update every tick */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Optimization, meta = (ClampMin = "0"))
+	int32 FixedUpdateMinLOD;
+
+	/** Let UParagonAnimBudgetSubsystem lower the update rate of this character when it is not significant enough for the frame budget */
+	UPROPERTY(EditDefaultsOnly, Category = Optimization)
+	bool bUseAnimationBudget;
+
+	/** Added to the significance the animation budget ranks this character by, e.g. for the current target */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Optimization)
+	float SignificanceBias;
+
+	/** Locomotion clips streamed in through UParagonAnimStreamingSubsystem while this character is alive */
+	UPROPERTY(EditDefaultsOnly, Category = Streaming)
+	UParagonLocomotionClipSet* ClipSet;
+
 public:
 	virtual void NativeBeginPlay() override;
-	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+	virtual void NativeUninitializeAnimation() override;
+
+	FParagonLocomotionSettings GetLocomotionSettings() const;
+
+	/** Write the locomotion inputs of every update to Filename until StopRecording, replay it with the ParagonLocomotionReplay commandlet */
+	UFUNCTION(BlueprintCallable, Category = Debug)
+	bool StartRecording(const FString& Filename);
+
+	UFUNCTION(BlueprintCallable, Category = Debug)
+	void StopRecording();
+
+	UFUNCTION(BlueprintPure, Category = Debug)
+	bool IsRecording() const { return Recorder.IsValid(); }
+
+protected:
+	// UAnimInstance interface
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
+	// End of UAnimInstance interface
 
 private:
-	FRotator ActorRotation;
-	FRotator MeshRotation;
-	FVector DistanceMachingStartLocation;
-	FVector DistanceMachingStopLocation;
+	friend struct FParagonAnimInstanceProxy;
+	friend class UParagonLocomotionSubsystem;
+	friend class UParagonAnimBudgetSubsystem;
+
+	FParagonAnimInstanceProxy& GetParagonProxyOnGameThread() { return GetProxyOnGameThread<FParagonAnimInstanceProxy>(); }
+
+	/** Copy the derived parameters into the blueprint visible properties */
+	void ApplyLocomotionState(const FParagonLocomotionState& State);
+
+	bool bRegisteredForBatchedUpdate;
+	bool bRegisteredForBudget;
+
+	/** ClipSet acquired in NativeBeginPlay, released again on uninitialize */
+	UPROPERTY(Transient)
+	UParagonLocomotionClipSet* AcquiredClipSet;
+
+	TSharedPtr<FParagonLocomotionRecorder, ESPMode::ThreadSafe> Recorder;
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/SoftObjectPtr.h"
+#include "ParagonAnimStreamingSubsystem.generated.h"
+
+class UAnimSequenceBase;
+class UParagonLocomotionClipSet;
+
+/**
+ * Streams the locomotion clips of the heroes in a world in and out.
+ * Clip sets are reference counted by the characters that use them. Clips nobody references stay resident until the
+ * Paragon.AnimStreaming.BudgetMB budget is exceeded, then the least recently used ones are released to garbage collection.
+ * Game thread only.
+ */
+UCLASS()
+class PARAGONANIMATION_API UParagonAnimStreamingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	// USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End of USubsystem interface
+
+	/** Start streaming the clips of the set in and keep them resident until the matching ReleaseClipSet, e.g. when a hero spawns or approaches */
+	UFUNCTION(BlueprintCallable, Category = Streaming)
+	void AcquireClipSet(const UParagonLocomotionClipSet* ClipSet);
+
+	UFUNCTION(BlueprintCallable, Category = Streaming)
+	void ReleaseClipSet(const UParagonLocomotionClipSet* ClipSet);
+
+	/** The clip if it is resident, otherwise starts streaming it without a reference and returns null */
+	UAnimSequenceBase* RequestSequence(const TSoftObjectPtr<UAnimSequenceBase>& Sequence);
+
+	int32 GetNumResident() const { return NumResident; }
+	int64 GetResidentBytes() const { return ResidentBytes; }
+
+private:
+	struct FEntry
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		int32 RefCount = 0;
+		int64 SizeBytes = 0;
+		uint64 LastUsedFrame = 0;
+		bool bResident = false;
+	};
+
+	FEntry& FindOrLoad(const FSoftObjectPath& Path);
+	void OnLoaded(FSoftObjectPath Path);
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+	/** Release unreferenced clips, least recently used first, until the resident set fits the budget */
+	void Evict(int64 BudgetBytes);
+
+private:
+	FStreamableManager StreamableManager;
+
+	TMap<FSoftObjectPath, FEntry> Entries;
+	int32 NumResident;
+	int64 ResidentBytes;
+
+	FDelegateHandle PostActorTickHandle;
+};
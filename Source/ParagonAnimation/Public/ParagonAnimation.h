@@ -12,4 +12,13 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	void OnPostGarbageCollect();
+#if WITH_EDITOR
+	void OnObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent);
+#endif
+
+	FDelegateHandle PostGarbageCollectHandle;
+	FDelegateHandle ObjectPropertyChangedHandle;
 };
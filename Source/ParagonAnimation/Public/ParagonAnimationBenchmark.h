@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+#include "HAL/PlatformTime.h"
+
+/** Compiled out of shipping builds, nothing is recorded until bEnabled is set, e.g. by the benchmark commandlet */
+#define PARAGON_WITH_BENCHMARK !UE_BUILD_SHIPPING
+
+#if PARAGON_WITH_BENCHMARK
+
+enum class EParagonBenchmarkScope : uint8
+{
+	InstanceUpdate,
+	NodeUpdate,
+	NodeEvaluate,
+	Num
+};
+
+/** Cycles spent in each scope summed over all threads since the last Reset */
+struct PARAGONANIMATION_API FParagonBenchmark
+{
+	static bool bEnabled;
+
+	static void Reset();
+
+	static double GetMilliseconds(EParagonBenchmarkScope Scope);
+
+	static void AddCycles(EParagonBenchmarkScope Scope, uint64 Cycles) { ScopeCycles[(int32)Scope] += Cycles; }
+
+private:
+	static TAtomic<uint64> ScopeCycles[(int32)EParagonBenchmarkScope::Num];
+};
+
+struct FParagonBenchmarkScope
+{
+	explicit FParagonBenchmarkScope(EParagonBenchmarkScope InScope)
+		: Scope(InScope)
+		, StartCycles(FParagonBenchmark::bEnabled ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FParagonBenchmarkScope()
+	{
+		if (StartCycles != 0)
+		{
+			FParagonBenchmark::AddCycles(Scope, FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+
+private:
+	EParagonBenchmarkScope Scope;
+	uint64 StartCycles;
+};
+
+#define PARAGON_BENCHMARK_SCOPE(Scope) FParagonBenchmarkScope ANONYMOUS_VARIABLE(ParagonBenchmarkScope)(EParagonBenchmarkScope::Scope)
+
+#else
+
+#define PARAGON_BENCHMARK_SCOPE(Scope)
+
+#endif // PARAGON_WITH_BENCHMARK
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <algorithm>
+
+namespace ParagonCore
+{
+	/**
+	 * Cross fade of a stack of clips where the newest blends in and all older ones blend out together.
+	 * Raises Weight, the weight of the newest clip, by Step and returns the factor to scale the weights of the older clips
+	 * with so all weights still sum to one. A clip interrupted mid-blend keeps fading out from the weight it had reached.
+	 */
+	inline float BlendInWeight(float& Weight, float Step)
+	{
+		const float Remaining = 1.f - Weight;
+		Weight = std::min(Weight + std::max(Step, 0.f), 1.f);
+		return Remaining > 0.f ? (1.f - Weight) / Remaining : 0.f;
+	}
+}
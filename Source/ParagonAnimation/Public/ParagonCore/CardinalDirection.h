@@ -0,0 +1,74 @@
+#pragma once
+
+#include "ParagonCore/CoreMath.h"
+
+namespace ParagonCore
+{
+	/** Same order as EAnimCardinalDirection */
+	enum class ECardinalDirection : unsigned char
+	{
+		North,
+		East,
+		South,
+		West,
+	};
+
+	struct FCardinalDirectionResult
+	{
+		ECardinalDirection Direction = ECardinalDirection::North;
+
+		/** Yaw that turns the mesh from the actor facing to the direction of the clip */
+		float MeshYawOffset = 0.f;
+	};
+
+	/**
+	 * Pick the clip direction from the yaw between the acceleration and the actor facing, in degrees.
+	 * Within 70 degrees of either facing runs forwards or backwards, the rest strafes.
+	 */
+	inline FCardinalDirectionResult ClassifyCardinalDirection(float InputYaw, float ActorYaw)
+	{
+		FCardinalDirectionResult Result;
+		float CardinalDirectionAngle = 0.f;
+
+		const float InputDelta = FindDeltaAngleDegrees(InputYaw, ActorYaw);
+		if (InputDelta > 0.f)
+		{
+			if (InputDelta < 70.f)
+			{
+				Result.Direction = ECardinalDirection::North;
+				CardinalDirectionAngle = InputDelta;
+			}
+			else if (InputDelta > 110.f)
+			{
+				Result.Direction = ECardinalDirection::South;
+				CardinalDirectionAngle = InputDelta + 180;
+			}
+			else
+			{
+				Result.Direction = ECardinalDirection::West;
+				CardinalDirectionAngle = InputDelta - 90;
+			}
+		}
+		else
+		{
+			if (InputDelta > -70.f)
+			{
+				Result.Direction = ECardinalDirection::North;
+				CardinalDirectionAngle = InputDelta;
+			}
+			else if (InputDelta < -110.f)
+			{
+				Result.Direction = ECardinalDirection::South;
+				CardinalDirectionAngle = InputDelta + 180;
+			}
+			else
+			{
+				Result.Direction = ECardinalDirection::East;
+				CardinalDirectionAngle = InputDelta + 90;
+			}
+		}
+
+		Result.MeshYawOffset = -CardinalDirectionAngle;
+		return Result;
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Engine independent math of the plugin, header only so it builds both in the engine modules and in the standalone
+ * CMake tests and benchmarks. The helpers reproduce the FMath and FVector functions the engine code used.
+ */
+namespace ParagonCore
+{
+	template <typename T>
+	inline T Clamp(const T X, const T Min, const T Max)
+	{
+		return X < Min ? Min : X < Max ? X : Max;
+	}
+
+	inline float Lerp(float A, float B, float Alpha)
+	{
+		return A + Alpha * (B - A);
+	}
+
+	inline int FloorToInt(float F)
+	{
+		return (int)std::floor(F);
+	}
+
+	inline int CeilToInt(float F)
+	{
+		return (int)std::ceil(F);
+	}
+
+	inline int RoundToInt(float F)
+	{
+		return FloorToInt(F + 0.5f);
+	}
+
+	/** Shortest signed angle from A1 to A2, in degrees */
+	inline float FindDeltaAngleDegrees(float A1, float A2)
+	{
+		float Delta = A2 - A1;
+		if (Delta > 180.f)
+		{
+			Delta -= 360.f;
+		}
+		else if (Delta < -180.f)
+		{
+			Delta += 360.f;
+		}
+		return Delta;
+	}
+
+	struct FVector3
+	{
+		float X = 0.f;
+		float Y = 0.f;
+		float Z = 0.f;
+
+		FVector3() = default;
+		FVector3(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+
+		FVector3 operator+(const FVector3& V) const { return FVector3(X + V.X, Y + V.Y, Z + V.Z); }
+		FVector3 operator-(const FVector3& V) const { return FVector3(X - V.X, Y - V.Y, Z - V.Z); }
+		FVector3 operator-() const { return FVector3(-X, -Y, -Z); }
+		FVector3 operator*(float Scale) const { return FVector3(X * Scale, Y * Scale, Z * Scale); }
+		FVector3& operator+=(const FVector3& V) { X += V.X; Y += V.Y; Z += V.Z; return *this; }
+
+		/** Dot product, same operator as FVector */
+		float operator|(const FVector3& V) const { return X * V.X + Y * V.Y + Z * V.Z; }
+
+		float SizeSquared() const { return X * X + Y * Y + Z * Z; }
+		float Size() const { return std::sqrt(SizeSquared()); }
+		bool IsZero() const { return X == 0.f && Y == 0.f && Z == 0.f; }
+
+		FVector3 GetSafeNormal(float Tolerance = 1.e-8f) const
+		{
+			const float SquareSum = SizeSquared();
+			if (SquareSum == 1.f)
+			{
+				return *this;
+			}
+			else if (SquareSum < Tolerance)
+			{
+				return FVector3();
+			}
+			return *this * (1.f / std::sqrt(SquareSum));
+		}
+
+		FVector3 ProjectOnToNormal(const FVector3& Normal) const
+		{
+			return Normal * (*this | Normal);
+		}
+	};
+
+	inline FVector3 operator*(float Scale, const FVector3& V)
+	{
+		return V * Scale;
+	}
+}
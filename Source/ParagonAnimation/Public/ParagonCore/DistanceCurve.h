@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include "ParagonCore/CoreMath.h"
+
+namespace ParagonCore
+{
+	/** Key of a distance curve, Value is the distance. FRichCurveKey has the same members and works as well */
+	struct FCurveKey
+	{
+		float Time;
+		float Value;
+	};
+
+	/**
+	 * Binary search the keys for the time at which the curve reaches Distance, interpolating linearly between keys.
+	 * Keys must be sorted by strictly increasing Value, see FDistanceCurveTable::Validate.
+	 */
+	template <typename KeyType>
+	inline float FindPositionFromDistanceCurve(const KeyType* Keys, int NumKeys, float Distance)
+	{
+		if (NumKeys < 2)
+		{
+			return 0.f;
+		}
+
+		int First = 1;
+		int Last = NumKeys - 1;
+		int Count = Last - First;
+
+		while (Count > 0)
+		{
+			const int Step = Count / 2;
+			const int Middle = First + Step;
+
+			if (Distance > Keys[Middle].Value)
+			{
+				First = Middle + 1;
+				Count -= Step + 1;
+			}
+			else
+			{
+				Count = Step;
+			}
+		}
+
+		const KeyType& KeyA = Keys[First - 1];
+		const KeyType& KeyB = Keys[First];
+		const float Diff = KeyB.Value - KeyA.Value;
+		const float Alpha = std::fabs(Diff) > 1.e-8f ? ((Distance - KeyA.Value) / Diff) : 0.f;
+		return Lerp(KeyA.Time, KeyB.Time, Alpha);
+	}
+
+	/** Range and scale of times quantized to 16 bits, time = TimeOffset + Quantized * TimeScale */
+	struct FTimeQuantization
+	{
+		float TimeOffset = 0.f;
+		float TimeScale = 0.f;
+	};
+
+	/** Quantize NumSamples times over their own range into OutQuantized */
+	inline FTimeQuantization QuantizeTimes(const float* Times, int NumSamples, uint16_t* OutQuantized)
+	{
+		FTimeQuantization Quantization;
+		if (NumSamples <= 0)
+		{
+			return Quantization;
+		}
+
+		float MinTime = Times[0];
+		float MaxTime = Times[0];
+		for (int SampleIndex = 1; SampleIndex < NumSamples; SampleIndex++)
+		{
+			MinTime = std::min(MinTime, Times[SampleIndex]);
+			MaxTime = std::max(MaxTime, Times[SampleIndex]);
+		}
+
+		const float MaxQuantizedTime = 65535.f;
+		Quantization.TimeOffset = MinTime;
+		Quantization.TimeScale = (MaxTime - MinTime) / MaxQuantizedTime;
+		const float InvTimeScale = Quantization.TimeScale > 0.f ? 1.f / Quantization.TimeScale : 0.f;
+
+		for (int SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+		{
+			OutQuantized[SampleIndex] = (uint16_t)Clamp(RoundToInt((Times[SampleIndex] - Quantization.TimeOffset) * InvTimeScale), 0, 65535);
+		}
+		return Quantization;
+	}
+
+	/** Constant time lookup in times sampled at uniformly spaced distances, extrapolates linearly outside of the sampled range */
+	inline float EvaluateQuantizedTable(const uint16_t* QuantizedTimes, int NumSamples, const FTimeQuantization& Quantization, float MinDistance, float InvDistanceStep, float Distance)
+	{
+		const int LastSegment = NumSamples - 2;
+		const float Position = (Distance - MinDistance) * InvDistanceStep;
+		const int Index = Clamp(FloorToInt(Position), 0, LastSegment);
+		return Quantization.TimeOffset + Quantization.TimeScale * Lerp((float)QuantizedTimes[Index], (float)QuantizedTimes[Index + 1], Position - Index);
+	}
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ParagonCore
+{
+	struct FNearestFeature
+	{
+		/** Row of the nearest point, -1 if there are no points */
+		int Index = -1;
+
+		float DistanceSquared = std::numeric_limits<float>::max();
+
+		/** Points the search compared against the query */
+		int NumComparisons = 0;
+	};
+
+	inline float FeatureDistanceSquared(const float* A, const float* B, int NumDimensions)
+	{
+		float DistanceSquared = 0.f;
+		for (int Dimension = 0; Dimension < NumDimensions; Dimension++)
+		{
+			const float Delta = A[Dimension] - B[Dimension];
+			DistanceSquared += Delta * Delta;
+		}
+		return DistanceSquared;
+	}
+
+	namespace Private
+	{
+		inline void BuildFeatureIndexRange(std::vector<int>& Order, const float* Points, uint8_t* SplitDimensions, int Begin, int End, int NumDimensions)
+		{
+			if (End - Begin <= 0)
+			{
+				return;
+			}
+
+			// Split along the widest dimension of the range
+			int SplitDimension = 0;
+			float WidestSpread = -1.f;
+			for (int Dimension = 0; Dimension < NumDimensions; Dimension++)
+			{
+				float Min = std::numeric_limits<float>::max();
+				float Max = -std::numeric_limits<float>::max();
+				for (int Position = Begin; Position < End; Position++)
+				{
+					const float Value = Points[Order[Position] * NumDimensions + Dimension];
+					Min = std::min(Min, Value);
+					Max = std::max(Max, Value);
+				}
+				if (Max - Min > WidestSpread)
+				{
+					WidestSpread = Max - Min;
+					SplitDimension = Dimension;
+				}
+			}
+
+			const int Middle = Begin + (End - Begin) / 2;
+			std::nth_element(Order.begin() + Begin, Order.begin() + Middle, Order.begin() + End, [Points, NumDimensions, SplitDimension](int A, int B)
+			{
+				return Points[A * NumDimensions + SplitDimension] < Points[B * NumDimensions + SplitDimension];
+			});
+			SplitDimensions[Middle] = (uint8_t)SplitDimension;
+
+			BuildFeatureIndexRange(Order, Points, SplitDimensions, Begin, Middle, NumDimensions);
+			BuildFeatureIndexRange(Order, Points, SplitDimensions, Middle + 1, End, NumDimensions);
+		}
+
+		inline void FindNearestFeatureInRange(const float* Points, const uint8_t* SplitDimensions, int Begin, int End, int NumDimensions, const float* Query, FNearestFeature& Best)
+		{
+			if (End - Begin <= 0)
+			{
+				return;
+			}
+
+			const int Middle = Begin + (End - Begin) / 2;
+			const float* Point = Points + Middle * NumDimensions;
+
+			Best.NumComparisons++;
+			const float DistanceSquared = FeatureDistanceSquared(Point, Query, NumDimensions);
+			if (DistanceSquared < Best.DistanceSquared)
+			{
+				Best.DistanceSquared = DistanceSquared;
+				Best.Index = Middle;
+			}
+
+			const int SplitDimension = SplitDimensions[Middle];
+			const float SplitDelta = Query[SplitDimension] - Point[SplitDimension];
+			const bool bLowerFirst = SplitDelta < 0.f;
+
+			if (bLowerFirst)
+				FindNearestFeatureInRange(Points, SplitDimensions, Begin, Middle, NumDimensions, Query, Best);
+			else
+				FindNearestFeatureInRange(Points, SplitDimensions, Middle + 1, End, NumDimensions, Query, Best);
+
+			// The other side can only hold a closer point if the splitting plane is closer than the best so far
+			if (SplitDelta * SplitDelta < Best.DistanceSquared)
+			{
+				if (bLowerFirst)
+					FindNearestFeatureInRange(Points, SplitDimensions, Middle + 1, End, NumDimensions, Query, Best);
+				else
+					FindNearestFeatureInRange(Points, SplitDimensions, Begin, Middle, NumDimensions, Query, Best);
+			}
+		}
+	}
+
+	/**
+	 * Reorder NumPoints rows of NumDimensions floats in place into an implicit balanced kd-tree.
+	 * The root of a range [Begin, End) is its middle row, split along SplitDimensions[Middle], with the lower half before
+	 * it and the upper half after it, so the tree needs one byte per point and no child links.
+	 * OutOrder, if given, receives the original row of every reordered row so the caller can reorder its payload.
+	 */
+	inline void BuildFeatureIndex(float* Points, uint8_t* SplitDimensions, int NumPoints, int NumDimensions, int* OutOrder = nullptr)
+	{
+		if (NumPoints <= 0 || NumDimensions <= 0)
+		{
+			return;
+		}
+
+		std::vector<int> Order(NumPoints);
+		for (int Row = 0; Row < NumPoints; Row++)
+		{
+			Order[Row] = Row;
+		}
+
+		Private::BuildFeatureIndexRange(Order, Points, SplitDimensions, 0, NumPoints, NumDimensions);
+
+		const std::vector<float> Unordered(Points, Points + NumPoints * NumDimensions);
+		for (int Row = 0; Row < NumPoints; Row++)
+		{
+			std::copy_n(Unordered.data() + Order[Row] * NumDimensions, NumDimensions, Points + Row * NumDimensions);
+			if (OutOrder)
+			{
+				OutOrder[Row] = Order[Row];
+			}
+		}
+	}
+
+	/** Nearest row of a BuildFeatureIndex tree to Query in squared euclidean distance, logarithmic on average */
+	inline FNearestFeature FindNearestFeature(const float* Points, const uint8_t* SplitDimensions, int NumPoints, int NumDimensions, const float* Query)
+	{
+		FNearestFeature Best;
+		Private::FindNearestFeatureInRange(Points, SplitDimensions, 0, NumPoints, NumDimensions, Query, Best);
+		return Best;
+	}
+
+	/** Reference linear scan, for tests and benchmarks */
+	inline FNearestFeature FindNearestFeatureLinear(const float* Points, int NumPoints, int NumDimensions, const float* Query)
+	{
+		FNearestFeature Best;
+		for (int Row = 0; Row < NumPoints; Row++)
+		{
+			Best.NumComparisons++;
+			const float DistanceSquared = FeatureDistanceSquared(Points + Row * NumDimensions, Query, NumDimensions);
+			if (DistanceSquared < Best.DistanceSquared)
+			{
+				Best.DistanceSquared = DistanceSquared;
+				Best.Index = Row;
+			}
+		}
+		return Best;
+	}
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "ParagonCore/CoreMath.h"
+
+namespace ParagonCore
+{
+	/**
+	 * Closed form of the braking branch of PredictStopLocation.
+	 * One TimeStep of the sub-stepped braking is the affine map v' = Scale * v - Offset, so the speed after n steps
+	 * and the distance travelled are geometric series. Matches the simulation up to float precision.
+	 */
+	inline bool ComputeBrakingStopDistance(
+		float& OutDistance,
+		const float Speed,
+		const float StopSpeed,
+		const float Friction,
+		const float BrakingDeceleration,
+		const float TimeStep,
+		const int MaxSimulationIterations)
+	{
+		const float MIN_TICK_TIME = 1e-6f;
+		const float MaxTimeStep = (1.0f / 33.0f);
+
+		float Scale = 1.f;
+		float Offset = 0.f;
+		float RemainingTime = TimeStep;
+		while (RemainingTime >= MIN_TICK_TIME)
+		{
+			const float dt = ((RemainingTime > MaxTimeStep && Friction != 0.f) ? std::min(MaxTimeStep, RemainingTime * 0.5f) : RemainingTime);
+			RemainingTime -= dt;
+
+			Scale *= 1.f - Friction * dt;
+			Offset = Offset * (1.f - Friction * dt) + BrakingDeceleration * dt;
+		}
+
+		// Stops within the first step
+		if (Speed <= StopSpeed || Scale <= 0.f || Scale * Speed - Offset <= StopSpeed)
+		{
+			OutDistance = 0.f;
+			return true;
+		}
+
+		if (Scale >= 1.f)
+		{
+			return false;
+		}
+
+		// v(n) + Fixed = Scale^n * (v(0) + Fixed)
+		const float Fixed = Offset / (1.f - Scale);
+		const int StopStep = std::max(1, CeilToInt(std::log((StopSpeed + Fixed) / (Speed + Fixed)) / std::log(Scale)));
+		if (StopStep > MaxSimulationIterations)
+		{
+			return false;
+		}
+
+		// The stopping step itself clamps the velocity to zero and does not move
+		const int MovingSteps = StopStep - 1;
+		const float SumOfScales = Scale * (1.f - std::pow(Scale, (float)MovingSteps)) / (1.f - Scale);
+		OutDistance = std::max(0.f, TimeStep * ((Speed + Fixed) * SumOfScales - Fixed * MovingSteps));
+		return true;
+	}
+
+	/**
+	 * Predict where braking brings the character to a stop, copy from CharacterMovementComponent.
+	 * OutIterations, if given, counts the simulated steps, the closed form counts as one.
+	 */
+	inline bool PredictStopLocation(
+		FVector3& OutStopLocation,
+		const FVector3& CurrentLocation,
+		const FVector3& Velocity,
+		const FVector3& Acceleration,
+		float Friction,
+		float BrakingDeceleration,
+		const float TimeStep,
+		const int MaxSimulationIterations,
+		const bool bAllowClosedForm = true,
+		int* OutIterations = nullptr)
+	{
+		int Iterations = 0;
+		if (OutIterations)
+		{
+			*OutIterations = 0;
+		}
+
+		const float MIN_TICK_TIME = 1e-6f;
+		if (TimeStep < MIN_TICK_TIME)
+		{
+			return false;
+		}
+		// Apply braking or deceleration
+		const bool bZeroAcceleration = Acceleration.IsZero();
+
+		if ((Acceleration | Velocity) > 0.0f)
+		{
+			return false;
+		}
+
+		BrakingDeceleration = std::max(BrakingDeceleration, 0.f);
+		Friction = std::max(Friction, 0.f);
+		const bool bZeroFriction = (Friction == 0.f);
+		const bool bZeroBraking = (BrakingDeceleration == 0.f);
+
+		if (bZeroAcceleration && bZeroFriction)
+		{
+			return false;
+		}
+
+		FVector3 LastVelocity = bZeroAcceleration ? Velocity : Velocity.ProjectOnToNormal(Acceleration.GetSafeNormal());
+		LastVelocity.Z = 0;
+
+		FVector3 LastLocation = CurrentLocation;
+
+		// Pure braking has an analytic solution, only input acceleration needs the simulation
+		if (bZeroAcceleration && bAllowClosedForm)
+		{
+			// Matches the clamps of the simulation below
+			const float StopSpeed = bZeroBraking ? 1.f : 10.f;
+
+			if (OutIterations)
+			{
+				*OutIterations = 1;
+			}
+
+			float StopDistance = 0.f;
+			if (!ComputeBrakingStopDistance(StopDistance, LastVelocity.Size(), StopSpeed, Friction, BrakingDeceleration, TimeStep, MaxSimulationIterations))
+			{
+				return false;
+			}
+
+			OutStopLocation = LastLocation + LastVelocity.GetSafeNormal() * StopDistance;
+			return true;
+		}
+
+		while (Iterations < MaxSimulationIterations)
+		{
+			Iterations++;
+			if (OutIterations)
+			{
+				*OutIterations = Iterations;
+			}
+
+			const FVector3 OldVel = LastVelocity;
+
+			// Only apply braking if there is no acceleration, or we are over our max speed and need to slow down to it.
+			if (bZeroAcceleration)
+			{
+				// subdivide braking to get reasonably consistent results at lower frame rates
+				// (important for packet loss situations w/ networking)
+				float RemainingTime = TimeStep;
+				const float MaxTimeStep = (1.0f / 33.0f);
+
+				// Decelerate to brake to a stop
+				const FVector3 RevAccel = (bZeroBraking ? FVector3() : (-BrakingDeceleration * LastVelocity.GetSafeNormal()));
+				while (RemainingTime >= MIN_TICK_TIME)
+				{
+					// Zero friction uses constant deceleration, so no need for iteration.
+					const float dt = ((RemainingTime > MaxTimeStep && !bZeroFriction) ? std::min(MaxTimeStep, RemainingTime * 0.5f) : RemainingTime);
+					RemainingTime -= dt;
+
+					// apply friction and braking
+					LastVelocity = LastVelocity + ((-Friction) * LastVelocity + RevAccel) * dt;
+
+					// Don't reverse direction
+					if ((LastVelocity | OldVel) <= 0.f)
+					{
+						LastVelocity = FVector3();
+						break;
+					}
+				}
+
+				// Clamp to zero if nearly zero, or if below min threshold and braking.
+				const float VSizeSq = LastVelocity.SizeSquared();
+				if (VSizeSq <= 1.f || (!bZeroBraking && VSizeSq <= 10.f * 10.f))
+				{
+					LastVelocity = FVector3();
+				}
+			}
+			else
+			{
+				FVector3 TotalAcceleration = Acceleration;
+				TotalAcceleration.Z = 0;
+
+				// Friction affects our ability to change direction. This is only done for input acceleration, not path following.
+				const FVector3 AccelDir = TotalAcceleration.GetSafeNormal();
+				const float VelSize = LastVelocity.Size();
+				TotalAcceleration += -(LastVelocity - AccelDir * VelSize) * Friction;
+				// Apply acceleration
+				LastVelocity += TotalAcceleration * TimeStep;
+			}
+
+			LastLocation += LastVelocity * TimeStep;
+
+			// Clamp to zero if nearly zero, or if below min threshold and braking.
+			const float VSizeSq = LastVelocity.SizeSquared();
+			if (VSizeSq <= 1.f
+				|| (LastVelocity | OldVel) <= 0.f)
+			{
+				OutStopLocation = LastLocation;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/** Constant deceleration estimate of the stop location, ignores friction, for characters too far away to notice */
+	inline FVector3 EstimateStopLocation(const FVector3& CurrentLocation, const FVector3& Velocity, float BrakingDeceleration)
+	{
+		const FVector3 Velocity2D(Velocity.X, Velocity.Y, 0.f);
+		const float StopDistance = BrakingDeceleration > 0.f ? Velocity2D.SizeSquared() / (2.f * BrakingDeceleration) : 0.f;
+		return CurrentLocation + Velocity2D.GetSafeNormal() * StopDistance;
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cmath>
+
+namespace ParagonCore
+{
+	/**
+	 * Root yaw offset left after a turn in place clip covered TurnedYaw degrees, in either direction.
+	 * Moves the offset towards zero by the magnitude of TurnedYaw and never past it, so the mesh ends up facing the actor.
+	 */
+	inline float ConsumeTurnYaw(float RootYawOffset, float TurnedYaw)
+	{
+		const float Remaining = std::fabs(RootYawOffset) - std::fabs(TurnedYaw);
+		return Remaining > 0.f ? std::copysign(Remaining, RootYawOffset) : 0.f;
+	}
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "ParagonLocomotion.generated.h"
+
+class ACharacter;
+
+UENUM(BlueprintType)
+enum class EAnimCardinalDirection : uint8
+{
+	North UMETA(DisplayName = "North"),
+	East UMETA(DisplayName = "East"),
+	South UMETA(DisplayName = "South"),
+	West UMETA(DisplayName = "West"),
+};
+
+/** Movement inputs of one character, gathered once per frame on the game thread */
+struct PARAGONANIMATION_API FParagonLocomotionInput
+{
+	FVector ActorLocation;
+	FVector Acceleration;
+	FVector Velocity;
+	FRotator ActorRotation;
+	FRotator BaseRotationOffset;
+	FRotator BaseAimRotation;
+	float BrakingFriction;
+	float BrakingDeceleration;
+	float MaxSimulationTimeStep;
+	bool bIsValid;
+
+	FParagonLocomotionInput();
+
+	/** Read the inputs from the character and its movement component, game thread only */
+	void Gather(const ACharacter* Character);
+};
+
+/** Tunables copied from the anim instance */
+struct PARAGONANIMATION_API FParagonLocomotionSettings
+{
+	float LeanFactor;
+	float LeanInterpSpeed;
+	float MeshRotationInterpSpeed;
+	float DistanceMachingScaling;
+
+	/** Simulate braking to find the stop location, otherwise use EstimateStopLocation */
+	bool bPredictStop;
+
+	/** Steps per second of UpdateFixedStep, 0 updates once per tick */
+	float FixedUpdateRate;
+
+	FParagonLocomotionSettings();
+};
+
+/** Derived locomotion parameters and the history they are computed from */
+struct PARAGONANIMATION_API FParagonLocomotionState
+{
+	bool IsAccelerating;
+	bool IsMoving;
+	float Lean;
+	EAnimCardinalDirection CardinalDirection;
+	float AimYaw;
+	float AimPitch;
+	float DistanceMachingStart;
+	float DistanceMachingStop;
+
+	/** Yaw between MeshRotation and the unrotated mesh, for rotating the root bone instead of the component. Held while not accelerating, so an idle character turns with its actor */
+	float RootYawOffset;
+
+	FRotator ActorRotation;
+	FRotator MeshRotation;
+	FVector DistanceMachingStartLocation;
+	FVector DistanceMachingStopLocation;
+
+	/** Set by the last update when acceleration started or stopped */
+	bool bStartedThisUpdate;
+	bool bStoppedThisUpdate;
+
+	FParagonLocomotionState();
+};
+
+/** The last two fixed rate steps and the time left over since the last one */
+struct PARAGONANIMATION_API FParagonLocomotionFixedStep
+{
+	FParagonLocomotionState Previous;
+	FParagonLocomotionState Current;
+	float Accumulator;
+
+	/** Start over from the state passed to the next UpdateFixedStep */
+	bool bInitialized;
+
+	FParagonLocomotionFixedStep();
+};
+
+namespace ParagonLocomotion
+{
+	/** Reset the rotation history to the character's current rotation */
+	PARAGONANIMATION_API void Initialize(FParagonLocomotionState& State, const FParagonLocomotionInput& Input);
+
+	/** Compute all derived parameters for one frame, touches no UObject so it can run on any thread */
+	PARAGONANIMATION_API void Update(FParagonLocomotionState& State, const FParagonLocomotionSettings& Settings, const FParagonLocomotionInput& Input, float DeltaSeconds);
+
+	/**
+	 * Run Update at Settings.FixedUpdateRate so the smoothing does not depend on the frame rate.
+	 * In between steps the distances and aim are recomputed from the current input and the smoothed values are
+	 * interpolated between the last two steps, so State lags the simulation by at most one step.
+	 */
+	PARAGONANIMATION_API void UpdateFixedStep(FParagonLocomotionState& State, FParagonLocomotionFixedStep& FixedStep, const FParagonLocomotionSettings& Settings, const FParagonLocomotionInput& Input, float DeltaSeconds);
+
+	/**
+	 * Turn the mesh towards the actor by the yaw a turn in place clip covered, so RootYawOffset reaches 0 when the turn ends.
+	 * Applied to the fixed steps too when FixedStep is initialized, otherwise the next interpolation would bring the offset back.
+	 */
+	PARAGONANIMATION_API void ConsumeTurnYaw(FParagonLocomotionState& State, FParagonLocomotionFixedStep& FixedStep, const FParagonLocomotionInput& Input, float TurnedYaw);
+
+	/** Predict where braking brings the character to a stop, copy from CharacterMovementComponent */
+	PARAGONANIMATION_API bool PredictStopLocation(
+		FVector& OutStopLocation,
+		const FVector& CurrentLocation,
+		const FVector& Velocity,
+		const FVector& Acceleration,
+		float Friction,
+		float BrakingDeceleration,
+		const float TimeStep,
+		const int MaxSimulationIterations,
+		const bool bAllowClosedForm = true);
+
+	/** Constant deceleration estimate of the stop location, ignores friction, for characters too far away to notice */
+	PARAGONANIMATION_API void EstimateStopLocation(
+		FVector& OutStopLocation,
+		const FVector& CurrentLocation,
+		const FVector& Velocity,
+		float BrakingDeceleration);
+}
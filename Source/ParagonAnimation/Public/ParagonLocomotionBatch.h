@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParagonLocomotion.h"
+
+/**
+ * Locomotion inputs and states of many characters stored as structure of arrays.
+ * Update runs branch free kernels over contiguous ranges split across cores with ParallelFor,
+ * producing the same results as ParagonLocomotion::Update for every slot.
+ */
+class PARAGONANIMATION_API FParagonLocomotionBatch
+{
+public:
+	int32 Num() const { return NumSlots; }
+
+	/** Add a slot initialized from State, returns its index */
+	int32 Add(const FParagonLocomotionState& State);
+
+	/** Remove the slot, the last slot is moved into its place */
+	void RemoveAtSwap(int32 Index);
+
+	void Reset();
+
+	/** Set the inputs of the next update, slots without valid inputs keep their state */
+	void SetInput(int32 Index, const FParagonLocomotionInput& Input, const FParagonLocomotionSettings& Settings);
+
+	/** Turn the mesh of the slot towards the actor by the yaw a turn in place clip covered, after SetInput */
+	void ConsumeTurnYaw(int32 Index, float TurnedYaw);
+
+	void Update(float DeltaSeconds);
+
+	void GetState(int32 Index, FParagonLocomotionState& OutState) const;
+
+	/** Whether the last inputs of the slot were valid */
+	bool IsActive(int32 Index) const { return Active[Index] != 0; }
+
+	/** Slots per ParallelFor task */
+	static int32 BatchSize;
+
+private:
+	void UpdateRange(int32 Begin, int32 End, float DeltaSeconds);
+	void SetState(int32 Index, const FParagonLocomotionState& State);
+
+	template <typename FuncType>
+	void ForEachArray(FuncType&& Func);
+
+private:
+	int32 NumSlots = 0;
+
+	// Inputs
+	TArray<uint8> Active;
+	TArray<float> LocationX, LocationY, LocationZ;
+	TArray<float> AccelerationX, AccelerationY, AccelerationZ;
+	TArray<float> VelocityX, VelocityY, VelocityZ;
+	TArray<float> ActorPitch, ActorYaw, ActorRoll;
+	TArray<float> OffsetPitch, OffsetYaw, OffsetRoll;
+	TArray<float> AimRotationPitch, AimRotationYaw, AimRotationRoll;
+	TArray<float> BrakingFriction, BrakingDeceleration, MaxSimulationTimeStep;
+	TArray<float> LeanFactor, LeanInterpSpeed, MeshRotationInterpSpeed, DistanceMachingScaling;
+	TArray<uint8> PredictStop;
+
+	// States
+	TArray<uint8> IsAccelerating, IsMoving, Started, Stopped;
+	TArray<uint8> CardinalDirection;
+	TArray<float> Lean, AimYaw, AimPitch, RootYawOffset;
+	TArray<float> DistanceMachingStart, DistanceMachingStop;
+	TArray<float> LastActorPitch, LastActorYaw, LastActorRoll;
+	TArray<float> MeshPitch, MeshYaw, MeshRoll;
+	TArray<float> StartX, StartY, StartZ;
+	TArray<float> StopX, StopY, StopZ;
+};
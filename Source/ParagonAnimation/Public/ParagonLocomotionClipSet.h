@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/SoftObjectPtr.h"
+#include "Engine/DataAsset.h"
+#include "Animation/AnimSequenceBase.h"
+#include "ParagonLocomotionClipSet.generated.h"
+
+/**
+ * The start, stop, slope and turn clips of one hero.
+ * Clips are soft references, UParagonAnimStreamingSubsystem streams them in while a hero that uses the set is around.
+ */
+UCLASS(BlueprintType)
+class PARAGONANIMATION_API UParagonLocomotionClipSet : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Clips)
+	TArray<TSoftObjectPtr<UAnimSequenceBase>> Sequences;
+};
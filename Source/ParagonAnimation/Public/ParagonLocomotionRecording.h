@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParagonLocomotion.h"
+
+/** One update of a recorded anim instance */
+struct PARAGONANIMATION_API FParagonLocomotionRecordedFrame
+{
+	float DeltaSeconds;
+	FParagonLocomotionInput Input;
+	FParagonLocomotionSettings Settings;
+
+	FParagonLocomotionRecordedFrame();
+};
+
+/**
+ * Writes the locomotion inputs of one anim instance to a compact binary file.
+ * The header stores the state the recording starts from, each frame the delta time and the inputs, the settings only when they changed.
+ * The file is closed when the recorder is destroyed.
+ */
+class PARAGONANIMATION_API FParagonLocomotionRecorder
+{
+public:
+	FParagonLocomotionRecorder();
+	~FParagonLocomotionRecorder();
+
+	/** Start a file at the current State and FixedStep of the instance, the replay continues from them */
+	bool Open(const FString& Filename, const FParagonLocomotionState& State, const FParagonLocomotionFixedStep& FixedStep);
+	void Close();
+
+	bool IsRecording() const { return Writer.IsValid(); }
+	int32 Num() const { return NumFrames; }
+
+	/** Append one update, must not be called from several threads at once */
+	void Record(float DeltaSeconds, const FParagonLocomotionInput& Input, const FParagonLocomotionSettings& Settings);
+
+private:
+	TUniquePtr<FArchive> Writer;
+	FParagonLocomotionSettings LastSettings;
+	bool bHasSettings;
+	int32 NumFrames;
+};
+
+namespace ParagonLocomotionRecording
+{
+	/** Extension of the files written by FParagonLocomotionRecorder */
+	PARAGONANIMATION_API extern const TCHAR* FileExtension;
+
+	/** Read a file written by FParagonLocomotionRecorder, returns false if it is not a recording or has an unknown version */
+	PARAGONANIMATION_API bool Load(const FString& Filename, FParagonLocomotionState& OutState, FParagonLocomotionFixedStep& OutFixedStep, TArray<FParagonLocomotionRecordedFrame>& OutFrames);
+}
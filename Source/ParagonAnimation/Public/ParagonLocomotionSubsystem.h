@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "ParagonLocomotionBatch.h"
+#include "ParagonLocomotionSubsystem.generated.h"
+
+class UParagonAnimInstance;
+
+/**
+ * Updates the locomotion parameters of all registered Paragon anim instances in one batch.
+ * Inputs are gathered after all actors ticked, the results are consumed by the anim instances on their next update.
+ */
+UCLASS()
+class PARAGONANIMATION_API UParagonLocomotionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	// USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End of USubsystem interface
+
+	void Register(UParagonAnimInstance* AnimInstance);
+	void Unregister(UParagonAnimInstance* AnimInstance);
+
+	int32 GetNumRegistered() const { return Instances.Num(); }
+
+private:
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+private:
+	/** Registered instances, index i owns slot i of the batch */
+	TArray<TWeakObjectPtr<UParagonAnimInstance>> Instances;
+
+	FParagonLocomotionBatch Batch;
+
+	/** Inputs of the last batch, handed to the proxies with their state */
+	TArray<FParagonLocomotionInput> Inputs;
+
+	/** Slots the anim graph turned in place since the last batch, their idle mesh is rotated too */
+	TBitArray<> Turned;
+
+	FDelegateHandle PostActorTickHandle;
+};
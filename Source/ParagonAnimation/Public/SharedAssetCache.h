@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/Atomic.h"
+
+/** Base of the data held by a TSharedAssetCache, marked stale when the cache drops it */
+struct FSharedAssetCacheEntry
+{
+	/** Set when an asset the entry was built from was edited or collected, holders should resolve the entry again */
+	bool IsStale() const { return bStale; }
+
+private:
+	template<typename KeyType, typename DataType> friend class TSharedAssetCache;
+	mutable TAtomic<bool> bStale { false };
+};
+
+/**
+ * Process wide cache of data built from assets, shared by every node that uses the same assets. Lookups are safe from worker threads.
+ * KeyType needs GetTypeHash and operator==, plus Uses(const FObjectKey&) and IsStale() telling whether it refers to an asset
+ * or to one that was garbage collected. DataType derives from FSharedAssetCacheEntry.
+ */
+template<typename KeyType, typename DataType>
+class TSharedAssetCache
+{
+public:
+	typedef TSharedPtr<const DataType, ESPMode::ThreadSafe> FDataPtr;
+
+	/** Drop all entries that use the asset, nodes holding them will resolve again on their next update */
+	void Invalidate(const UObject* Object)
+	{
+		if (!Object)
+		{
+			return;
+		}
+
+		const FObjectKey ObjectKey(Object);
+		RemoveEntries([&ObjectKey](const KeyType& Key) { return Key.Uses(ObjectKey); });
+	}
+
+	/** Drop entries whose assets were garbage collected */
+	void RemoveStaleEntries()
+	{
+		RemoveEntries([](const KeyType& Key) { return Key.IsStale(); });
+	}
+
+	void Reset()
+	{
+		FWriteScopeLock WriteLock(Lock);
+		for (auto& Entry : Entries)
+		{
+			Entry.Value->bStale = true;
+		}
+		Entries.Empty();
+	}
+
+	int32 Num() const
+	{
+		FReadScopeLock ReadLock(Lock);
+		return Entries.Num();
+	}
+
+protected:
+	/** Find the entry of Key, calling Build for a TSharedPtr<DataType, ESPMode::ThreadSafe> on first use */
+	template<typename BuildFuncType>
+	FDataPtr FindOrAddEntry(const KeyType& Key, BuildFuncType&& Build)
+	{
+		{
+			FReadScopeLock ReadLock(Lock);
+			if (const FDataPtr* Found = Entries.Find(Key))
+			{
+				return *Found;
+			}
+		}
+
+		// Build outside of the lock, another thread may win the race in which case its data is kept
+		FDataPtr NewData = Build();
+
+		FWriteScopeLock WriteLock(Lock);
+		if (const FDataPtr* Found = Entries.Find(Key))
+		{
+			return *Found;
+		}
+
+		return Entries.Add(Key, NewData);
+	}
+
+private:
+	template<typename PredicateType>
+	void RemoveEntries(PredicateType&& Predicate)
+	{
+		FWriteScopeLock WriteLock(Lock);
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (Predicate(It.Key()))
+			{
+				It.Value()->bStale = true;
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+private:
+	TMap<KeyType, FDataPtr> Entries;
+	mutable FRWLock Lock;
+};
@@ -44,6 +44,8 @@ public class ParagonAnimationEditor : ModuleRules
                 "AnimGraph",
 				"BlueprintGraph",
                 "GraphEditor",
+				"AssetRegistry",
+				"ContentBrowser",
             }
 			);
 		
@@ -0,0 +1,125 @@
+#include "AnimGraphNode_AngleMatching.h"
+#include "Kismet2/CompilerResultsLog.h"
+#include "Animation/AnimCurveTypes.h"
+
+#define LOCTEXT_NAMESPACE "A3Nodes"
+
+void UAnimGraphNode_AngleMatching::PreloadRequiredAssets()
+{
+	PreloadObject(Node.Sequence);
+
+	Super::PreloadRequiredAssets();
+}
+
+void UAnimGraphNode_AngleMatching::BakeDataDuringCompilation(class FCompilerResultsLog& MessageLog)
+{
+	UAnimBlueprint* AnimBlueprint = GetAnimBlueprint();
+	AnimBlueprint->FindOrAddGroup(SyncGroup.GroupName);
+	Node.GroupName = SyncGroup.GroupName;
+	Node.GroupRole = SyncGroup.GroupRole;
+	Node.Method = SyncGroup.Method;
+
+	if (!Node.BakeAngleCurve() && Node.Sequence)
+	{
+		MessageLog.Warning(*FString::Printf(TEXT("@@ could not bake angle curve '%s', it will be searched at runtime"), *Node.CurveName.ToString()), this);
+	}
+}
+
+void UAnimGraphNode_AngleMatching::GetAllAnimationSequencesReferred(TArray<UAnimationAsset*>& AnimationAssets) const
+{
+	if (Node.Sequence)
+	{
+		HandleAnimReferenceCollection(Node.Sequence, AnimationAssets);
+	}
+}
+
+void UAnimGraphNode_AngleMatching::ReplaceReferredAnimations(const TMap<UAnimationAsset*, UAnimationAsset*>& AnimAssetReplacementMap)
+{
+	HandleAnimReferenceReplacement(Node.Sequence, AnimAssetReplacementMap);
+}
+
+FText UAnimGraphNode_AngleMatching::GetTooltipText() const
+{
+	// FText::Format() is slow, so we utilize the cached list title
+	return GetNodeTitle(ENodeTitleType::ListView);
+}
+
+FText UAnimGraphNode_AngleMatching::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+	if (Node.Sequence == nullptr)
+	{
+		return LOCTEXT("AngleMatching", "AngleMatching");
+	}
+
+	FFormatNamedArguments Args;
+	Args.Add(TEXT("SequenceName"), FText::FromString(Node.Sequence->GetName()));
+
+	// FText::Format() is slow, so we cache this to save on performance
+	CachedNodeTitle.SetCachedText(FText::Format(LOCTEXT("AngleMatching_Sequence", "AngleMatching {SequenceName}"), Args), this);
+	return CachedNodeTitle;
+}
+
+FString UAnimGraphNode_AngleMatching::GetNodeCategory() const
+{
+	return TEXT("Paragon");
+}
+
+void UAnimGraphNode_AngleMatching::SetAnimationAsset(UAnimationAsset* Asset)
+{
+	if (UAnimSequenceBase* Seq = Cast<UAnimSequence>(Asset))
+	{
+		Node.Sequence = Seq;
+	}
+}
+
+void UAnimGraphNode_AngleMatching::ValidateAnimNodeDuringCompilation(class USkeleton* ForSkeleton, class FCompilerResultsLog& MessageLog)
+{
+	Super::ValidateAnimNodeDuringCompilation(ForSkeleton, MessageLog);
+
+	UAnimSequenceBase* SequenceToCheck = Node.Sequence;
+	UEdGraphPin* SequencePin = FindPin(GET_MEMBER_NAME_STRING_CHECKED(FAnimNode_AngleMatching, Sequence));
+	if (SequencePin != nullptr && SequenceToCheck == nullptr)
+	{
+		SequenceToCheck = Cast<UAnimSequenceBase>(SequencePin->DefaultObject);
+	}
+
+	if (SequenceToCheck == nullptr)
+	{
+		// we may have a connected node
+		if (SequencePin == nullptr || SequencePin->LinkedTo.Num() == 0)
+		{
+			MessageLog.Error(TEXT("@@ references an unknown sequence"), this);
+		}
+		return;
+	}
+
+	USkeleton* SeqSkeleton = SequenceToCheck->GetSkeleton();
+	if (SeqSkeleton && !SeqSkeleton->IsCompatible(ForSkeleton))
+	{
+		MessageLog.Error(TEXT("@@ references sequence that uses different skeleton @@"), this, SeqSkeleton);
+	}
+
+	const FFloatCurve* AngleCurve = FDistanceCurveTable::FindCurve(SequenceToCheck, Node.CurveName);
+	FString CurveError;
+	if (AngleCurve == nullptr)
+	{
+		MessageLog.Warning(*FString::Printf(TEXT("@@ sequence @@ has no angle curve '%s'"), *Node.CurveName.ToString()), this, SequenceToCheck);
+	}
+	else if (!FDistanceCurveTable::Validate(*AngleCurve, &CurveError))
+	{
+		MessageLog.Warning(*FString::Printf(TEXT("@@ angle curve '%s' of @@ %s"), *Node.CurveName.ToString(), *CurveError), this, SequenceToCheck);
+	}
+}
+
+UAnimationAsset* UAnimGraphNode_AngleMatching::GetAnimationAsset() const
+{
+	return Node.Sequence;
+}
+
+EAnimAssetHandlerType UAnimGraphNode_AngleMatching::SupportsAssetClass(const UClass* AssetClass) const
+{
+	// Sequences are claimed by the distance matching node
+	return EAnimAssetHandlerType::NotSupported;
+}
+
+#undef LOCTEXT_NAMESPACE
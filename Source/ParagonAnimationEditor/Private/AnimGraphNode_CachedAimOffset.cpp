@@ -0,0 +1,90 @@
+#include "AnimGraphNode_CachedAimOffset.h"
+#include "Kismet2/CompilerResultsLog.h"
+
+#define LOCTEXT_NAMESPACE "A3Nodes"
+
+FText UAnimGraphNode_CachedAimOffset::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+	return LOCTEXT("CachedAimOffset", "Cached Aim Offset");
+}
+
+FText UAnimGraphNode_CachedAimOffset::GetTooltipText() const
+{
+	return LOCTEXT("CachedAimOffset_Tooltip", "Aim offset over nine mesh space additive poses that are decompressed once per skeleton and only blended at runtime");
+}
+
+FString UAnimGraphNode_CachedAimOffset::GetNodeCategory() const
+{
+	return TEXT("Paragon");
+}
+
+void UAnimGraphNode_CachedAimOffset::PreloadRequiredAssets()
+{
+	UAnimSequence* Poses[FAimOffsetPoseData::NumPoses];
+	Node.Poses.GetPoses(Poses);
+	for (UAnimSequence* Pose : Poses)
+	{
+		PreloadObject(Pose);
+	}
+
+	Super::PreloadRequiredAssets();
+}
+
+void UAnimGraphNode_CachedAimOffset::GetAllAnimationSequencesReferred(TArray<UAnimationAsset*>& AnimationAssets) const
+{
+	UAnimSequence* Poses[FAimOffsetPoseData::NumPoses];
+	Node.Poses.GetPoses(Poses);
+	for (UAnimSequence* Pose : Poses)
+	{
+		if (Pose)
+		{
+			HandleAnimReferenceCollection(Pose, AnimationAssets);
+		}
+	}
+}
+
+void UAnimGraphNode_CachedAimOffset::ReplaceReferredAnimations(const TMap<UAnimationAsset*, UAnimationAsset*>& AnimAssetReplacementMap)
+{
+	FAimOffsetPoseSet& Poses = Node.Poses;
+	for (UAnimSequence** Pose : { &Poses.LeftDown, &Poses.CenterDown, &Poses.RightDown, &Poses.LeftCenter, &Poses.CenterCenter, &Poses.RightCenter, &Poses.LeftUp, &Poses.CenterUp, &Poses.RightUp })
+	{
+		HandleAnimReferenceReplacement(*Pose, AnimAssetReplacementMap);
+	}
+}
+
+void UAnimGraphNode_CachedAimOffset::ValidateAnimNodeDuringCompilation(class USkeleton* ForSkeleton, class FCompilerResultsLog& MessageLog)
+{
+	Super::ValidateAnimNodeDuringCompilation(ForSkeleton, MessageLog);
+
+	UAnimSequence* Poses[FAimOffsetPoseData::NumPoses];
+	Node.Poses.GetPoses(Poses);
+
+	for (UAnimSequence* Pose : Poses)
+	{
+		if (!Pose)
+		{
+			MessageLog.Warning(TEXT("@@ is missing aim offset poses, they are treated as no offset"), this);
+			break;
+		}
+	}
+
+	for (UAnimSequence* Pose : Poses)
+	{
+		if (!Pose)
+		{
+			continue;
+		}
+
+		USkeleton* SeqSkeleton = Pose->GetSkeleton();
+		if (SeqSkeleton && !SeqSkeleton->IsCompatible(ForSkeleton))
+		{
+			MessageLog.Error(TEXT("@@ references sequence @@ that uses different skeleton @@"), this, Pose, SeqSkeleton);
+		}
+		else if (Pose->AdditiveAnimType != AAT_RotationOffsetMeshSpace)
+		{
+			MessageLog.Warning(TEXT("@@ pose @@ is not a mesh space additive and is ignored"), this, Pose);
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
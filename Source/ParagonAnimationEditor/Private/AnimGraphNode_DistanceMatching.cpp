@@ -4,11 +4,13 @@
 #include "Kismet2/CompilerResultsLog.h"
 #include "GraphEditorActions.h"
 #include "Animation/AnimComposite.h"
+#include "Animation/AnimCurveTypes.h"
 
 #define LOCTEXT_NAMESPACE "A3Nodes"
 
 void UAnimGraphNode_DistanceMatching::PreloadRequiredAssets()
 {
+	// StreamedSequence is left to UParagonAnimStreamingSubsystem
 	PreloadObject(Node.Sequence);
 
 	Super::PreloadRequiredAssets();
@@ -21,6 +23,11 @@ void UAnimGraphNode_DistanceMatching::BakeDataDuringCompilation(class FCompilerR
 	Node.GroupName = SyncGroup.GroupName;
 	Node.GroupRole = SyncGroup.GroupRole;
 	Node.Method = SyncGroup.Method;
+
+	if (!Node.BakeDistanceCurve() && (Node.Sequence || !Node.StreamedSequence.IsNull()))
+	{
+		MessageLog.Warning(*FString::Printf(TEXT("@@ could not bake distance curve '%s', it will be searched at runtime"), *Node.CurveName.ToString()), this);
+	}
 }
 
 void UAnimGraphNode_DistanceMatching::OnProcessDuringCompilation(IAnimBlueprintCompilationContext& InCompilationContext, IAnimBlueprintGeneratedClassCompiledData& OutCompiledData)
@@ -68,7 +75,13 @@ FText UAnimGraphNode_DistanceMatching::GetNodeTitleForSequence(ENodeTitleType::T
 
 FText UAnimGraphNode_DistanceMatching::GetNodeTitle(ENodeTitleType::Type TitleType) const
 {
-	if (Node.Sequence == nullptr)
+	if (Node.Sequence == nullptr && !Node.StreamedSequence.IsNull())
+	{
+		FFormatNamedArguments Args;
+		Args.Add(TEXT("SequenceName"), FText::FromString(Node.StreamedSequence.GetAssetName()));
+		CachedNodeTitle.SetCachedText(FText::Format(LOCTEXT("DistanceMatching_Streamed", "DistanceMatching {SequenceName} (streamed)"), Args), this);
+	}
+	else if (Node.Sequence == nullptr)
 	{
 		return LOCTEXT("DistanceMatching", "DistanceMatching");
 	}
@@ -104,6 +117,17 @@ void UAnimGraphNode_DistanceMatching::ValidateAnimNodeDuringCompilation(class US
 		SequenceToCheck = Cast<UAnimSequenceBase>(SequencePin->DefaultObject);
 	}
 
+	// The fallback only plays while the streamed clip loads, the streamed one is what has to match
+	if (!Node.StreamedSequence.IsNull())
+	{
+		SequenceToCheck = Node.StreamedSequence.LoadSynchronous();
+		if (SequenceToCheck == nullptr)
+		{
+			MessageLog.Error(*FString::Printf(TEXT("@@ references streamed sequence '%s' that could not be loaded"), *Node.StreamedSequence.ToString()), this);
+			return;
+		}
+	}
+
 	if (SequenceToCheck == nullptr)
 	{
 		// we may have a connected node
@@ -120,6 +144,18 @@ void UAnimGraphNode_DistanceMatching::ValidateAnimNodeDuringCompilation(class US
 		{
 			MessageLog.Error(TEXT("@@ references sequence that uses different skeleton @@"), this, SeqSkeleton);
 		}
+
+		// Checked here once so the runtime lookup does not have to
+		const FFloatCurve* DistanceCurve = FDistanceCurveTable::FindCurve(SequenceToCheck, Node.CurveName);
+		FString CurveError;
+		if (DistanceCurve == nullptr)
+		{
+			MessageLog.Warning(*FString::Printf(TEXT("@@ sequence @@ has no distance curve '%s'"), *Node.CurveName.ToString()), this, SequenceToCheck);
+		}
+		else if (!FDistanceCurveTable::Validate(*DistanceCurve, &CurveError))
+		{
+			MessageLog.Warning(*FString::Printf(TEXT("@@ distance curve '%s' of @@ %s"), *Node.CurveName.ToString(), *CurveError), this, SequenceToCheck);
+		}
 	}
 }
 
@@ -142,7 +178,7 @@ UAnimationAsset* UAnimGraphNode_DistanceMatching::GetAnimationAsset() const
 
 const TCHAR* UAnimGraphNode_DistanceMatching::GetTimePropertyName() const
 {
-	return TEXT("ExplicitTime");
+	return TEXT("InternalTimeAccumulator");
 }
 
 UScriptStruct* UAnimGraphNode_DistanceMatching::GetTimePropertyStruct() const
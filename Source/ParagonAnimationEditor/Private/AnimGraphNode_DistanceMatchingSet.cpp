@@ -0,0 +1,95 @@
+#include "AnimGraphNode_DistanceMatchingSet.h"
+#include "Kismet2/CompilerResultsLog.h"
+#include "Animation/AnimCurveTypes.h"
+
+#define LOCTEXT_NAMESPACE "A3Nodes"
+
+FText UAnimGraphNode_DistanceMatchingSet::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+	return LOCTEXT("DistanceMatchingSet", "Distance Matching Set");
+}
+
+FText UAnimGraphNode_DistanceMatchingSet::GetTooltipText() const
+{
+	return LOCTEXT("DistanceMatchingSet_Tooltip", "Distance matches the start or stop clip of the current direction, cross fading when the selection changes");
+}
+
+FString UAnimGraphNode_DistanceMatchingSet::GetNodeCategory() const
+{
+	return TEXT("Distance Matching");
+}
+
+void UAnimGraphNode_DistanceMatchingSet::GetAllSequences(TArray<UAnimSequenceBase*>& OutSequences) const
+{
+	Node.StartClips.GetAll(OutSequences);
+	Node.StopClips.GetAll(OutSequences);
+}
+
+void UAnimGraphNode_DistanceMatchingSet::PreloadRequiredAssets()
+{
+	TArray<UAnimSequenceBase*> Sequences;
+	GetAllSequences(Sequences);
+	for (UAnimSequenceBase* Sequence : Sequences)
+	{
+		PreloadObject(Sequence);
+	}
+
+	Super::PreloadRequiredAssets();
+}
+
+void UAnimGraphNode_DistanceMatchingSet::GetAllAnimationSequencesReferred(TArray<UAnimationAsset*>& AnimationAssets) const
+{
+	TArray<UAnimSequenceBase*> Sequences;
+	GetAllSequences(Sequences);
+	for (UAnimSequenceBase* Sequence : Sequences)
+	{
+		HandleAnimReferenceCollection(Sequence, AnimationAssets);
+	}
+}
+
+void UAnimGraphNode_DistanceMatchingSet::ReplaceReferredAnimations(const TMap<UAnimationAsset*, UAnimationAsset*>& AnimAssetReplacementMap)
+{
+	for (FDistanceMatchingDirectionalClips* Clips : { &Node.StartClips, &Node.StopClips })
+	{
+		HandleAnimReferenceReplacement(Clips->North, AnimAssetReplacementMap);
+		HandleAnimReferenceReplacement(Clips->East, AnimAssetReplacementMap);
+		HandleAnimReferenceReplacement(Clips->South, AnimAssetReplacementMap);
+		HandleAnimReferenceReplacement(Clips->West, AnimAssetReplacementMap);
+	}
+}
+
+void UAnimGraphNode_DistanceMatchingSet::ValidateAnimNodeDuringCompilation(class USkeleton* ForSkeleton, class FCompilerResultsLog& MessageLog)
+{
+	Super::ValidateAnimNodeDuringCompilation(ForSkeleton, MessageLog);
+
+	TArray<UAnimSequenceBase*> Sequences;
+	GetAllSequences(Sequences);
+
+	if (Sequences.Num() == 0)
+	{
+		MessageLog.Warning(TEXT("@@ has no start or stop clips"), this);
+	}
+
+	for (UAnimSequenceBase* Sequence : Sequences)
+	{
+		USkeleton* SeqSkeleton = Sequence->GetSkeleton();
+		if (SeqSkeleton && !SeqSkeleton->IsCompatible(ForSkeleton))
+		{
+			MessageLog.Error(TEXT("@@ references sequence @@ that uses different skeleton @@"), this, Sequence, SeqSkeleton);
+		}
+		else if (const FFloatCurve* DistanceCurve = FDistanceCurveTable::FindCurve(Sequence, Node.CurveName))
+		{
+			FString CurveError;
+			if (!FDistanceCurveTable::Validate(*DistanceCurve, &CurveError))
+			{
+				MessageLog.Warning(*FString::Printf(TEXT("@@ distance curve '%s' of @@ %s"), *Node.CurveName.ToString(), *CurveError), this, Sequence);
+			}
+		}
+		else
+		{
+			MessageLog.Warning(*FString::Printf(TEXT("@@ sequence @@ has no distance curve '%s'"), *Node.CurveName.ToString()), this, Sequence);
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,25 @@
+#include "AnimGraphNode_RootYawOffset.h"
+
+#define LOCTEXT_NAMESPACE "A3Nodes"
+
+FText UAnimGraphNode_RootYawOffset::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+	return LOCTEXT("RootYawOffset", "Root Yaw Offset");
+}
+
+FText UAnimGraphNode_RootYawOffset::GetTooltipText() const
+{
+	return LOCTEXT("RootYawOffset_Tooltip", "Rotates the root bone around the up axis, use with UParagonAnimInstance::RootYawOffset instead of rotating the mesh component.");
+}
+
+FLinearColor UAnimGraphNode_RootYawOffset::GetNodeTitleColor() const
+{
+	return FLinearColor(0.75f, 0.75f, 0.75f);
+}
+
+FString UAnimGraphNode_RootYawOffset::GetNodeCategory() const
+{
+	return TEXT("Paragon");
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,121 @@
+#include "AnimGraphNode_StartStopMatching.h"
+#include "Kismet2/CompilerResultsLog.h"
+#include "Animation/AnimCurveTypes.h"
+
+#define LOCTEXT_NAMESPACE "A3Nodes"
+
+FText UAnimGraphNode_StartStopMatching::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+	return LOCTEXT("StartStopMatching", "Start Stop Matching");
+}
+
+FText UAnimGraphNode_StartStopMatching::GetTooltipText() const
+{
+	return LOCTEXT("StartStopMatching_Tooltip", "Selects the start or stop clip and entry time closest to the predicted movement, then distance matches it");
+}
+
+FString UAnimGraphNode_StartStopMatching::GetNodeCategory() const
+{
+	return TEXT("Paragon");
+}
+
+void UAnimGraphNode_StartStopMatching::GetAllSequences(TArray<UAnimSequence*>& OutSequences) const
+{
+	for (const TArray<UAnimSequence*>* Clips : { &Node.StartClips, &Node.StopClips })
+	{
+		for (UAnimSequence* Sequence : *Clips)
+		{
+			if (Sequence)
+			{
+				OutSequences.AddUnique(Sequence);
+			}
+		}
+	}
+}
+
+void UAnimGraphNode_StartStopMatching::PreloadRequiredAssets()
+{
+	TArray<UAnimSequence*> Sequences;
+	GetAllSequences(Sequences);
+	for (UAnimSequence* Sequence : Sequences)
+	{
+		PreloadObject(Sequence);
+	}
+
+	Super::PreloadRequiredAssets();
+}
+
+void UAnimGraphNode_StartStopMatching::BakeDataDuringCompilation(class FCompilerResultsLog& MessageLog)
+{
+	Node.BakeFeatureDatabases();
+
+	if (Node.StartClips.Num() > 0 && !Node.StartDatabase.IsValid())
+	{
+		MessageLog.Warning(TEXT("@@ could not sample any start clip, starts will not select a clip"), this);
+	}
+	if (Node.StopClips.Num() > 0 && !Node.StopDatabase.IsValid())
+	{
+		MessageLog.Warning(TEXT("@@ could not sample any stop clip, stops will not select a clip"), this);
+	}
+	if (Node.FeatureSettings.FootPhaseWeight > 0.f && (Node.StartDatabase.IsValid() || Node.StopDatabase.IsValid()) && !Node.StartDatabase.bHasFootPhase && !Node.StopDatabase.bHasFootPhase)
+	{
+		MessageLog.Warning(*FString::Printf(TEXT("@@ foot bones '%s' and '%s' were not found, clips are matched without foot phase"),
+			*Node.FeatureSettings.LeftFootBone.ToString(), *Node.FeatureSettings.RightFootBone.ToString()), this);
+	}
+}
+
+void UAnimGraphNode_StartStopMatching::GetAllAnimationSequencesReferred(TArray<UAnimationAsset*>& AnimationAssets) const
+{
+	TArray<UAnimSequence*> Sequences;
+	GetAllSequences(Sequences);
+	for (UAnimSequence* Sequence : Sequences)
+	{
+		HandleAnimReferenceCollection(Sequence, AnimationAssets);
+	}
+}
+
+void UAnimGraphNode_StartStopMatching::ReplaceReferredAnimations(const TMap<UAnimationAsset*, UAnimationAsset*>& AnimAssetReplacementMap)
+{
+	for (TArray<UAnimSequence*>* Clips : { &Node.StartClips, &Node.StopClips })
+	{
+		for (UAnimSequence*& Sequence : *Clips)
+		{
+			HandleAnimReferenceReplacement(Sequence, AnimAssetReplacementMap);
+		}
+	}
+}
+
+void UAnimGraphNode_StartStopMatching::ValidateAnimNodeDuringCompilation(class USkeleton* ForSkeleton, class FCompilerResultsLog& MessageLog)
+{
+	Super::ValidateAnimNodeDuringCompilation(ForSkeleton, MessageLog);
+
+	if (Node.StartClips.Num() == 0 && Node.StopClips.Num() == 0)
+	{
+		MessageLog.Warning(TEXT("@@ has no start or stop clips"), this);
+	}
+
+	TArray<UAnimSequence*> Sequences;
+	GetAllSequences(Sequences);
+	for (UAnimSequence* Sequence : Sequences)
+	{
+		USkeleton* SeqSkeleton = Sequence->GetSkeleton();
+		if (SeqSkeleton && !SeqSkeleton->IsCompatible(ForSkeleton))
+		{
+			MessageLog.Error(TEXT("@@ references sequence @@ that uses different skeleton @@"), this, Sequence, SeqSkeleton);
+		}
+		else if (const FFloatCurve* DistanceCurve = FDistanceCurveTable::FindCurve(Sequence, Node.CurveName))
+		{
+			FString CurveError;
+			if (!FDistanceCurveTable::Validate(*DistanceCurve, &CurveError))
+			{
+				MessageLog.Warning(*FString::Printf(TEXT("@@ distance curve '%s' of @@ %s"), *Node.CurveName.ToString(), *CurveError), this, Sequence);
+			}
+		}
+		else
+		{
+			MessageLog.Warning(*FString::Printf(TEXT("@@ sequence @@ has no distance curve '%s'"), *Node.CurveName.ToString()), this, Sequence);
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,236 @@
+#include "DistanceCurveGenerator.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Animation/Skeleton.h"
+#include "Async/ParallelFor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDistanceCurveGenerator, Log, All);
+
+FDistanceCurveGeneratorSettings::FDistanceCurveGeneratorSettings()
+	: CurveName(TEXT("DistanceCurve"))
+	, TurnCurveName(TEXT("TurnCurve"))
+	, Phase(EDistanceCurvePhase::Auto)
+	, MinDistanceStep(0.1f)
+{
+}
+
+EDistanceCurvePhase DistanceCurveGenerator::GetPhase(const UAnimSequence* Sequence, EDistanceCurvePhase Phase)
+{
+	if (Phase != EDistanceCurvePhase::Auto || !Sequence)
+	{
+		return Phase;
+	}
+
+	const FString Name = Sequence->GetName();
+	if (Name.Contains(TEXT("Turn")))
+	{
+		return EDistanceCurvePhase::Turn;
+	}
+	else if (Name.Contains(TEXT("Stop")))
+	{
+		return EDistanceCurvePhase::Stop;
+	}
+	else if (Name.Contains(TEXT("Start")))
+	{
+		return EDistanceCurvePhase::Start;
+	}
+
+	return EDistanceCurvePhase::Auto;
+}
+
+bool DistanceCurveGenerator::ComputeKeys(const UAnimSequence* Sequence, EDistanceCurvePhase Phase, float MinDistanceStep, TArray<FRichCurveKey>& OutKeys, FString& OutError)
+{
+	OutKeys.Reset();
+
+	if (Phase == EDistanceCurvePhase::Auto)
+	{
+		OutError = TEXT("is neither a start, a stop nor a turn");
+		return false;
+	}
+
+	const int32 NumFrames = Sequence->GetRawNumberOfFrames();
+	if (NumFrames < 2)
+	{
+		OutError = FString::Printf(TEXT("has %d frames"), NumFrames);
+		return false;
+	}
+
+	const int32 RootTrack = Sequence->GetRawTrackToSkeletonMapTable().IndexOfByPredicate([](const FTrackToSkeletonMap& TrackMap) { return TrackMap.BoneTreeIndex == 0; });
+	if (RootTrack == INDEX_NONE)
+	{
+		OutError = TEXT("has no root bone track");
+		return false;
+	}
+
+	const FRawAnimSequenceTrack& Track = Sequence->GetRawAnimationData()[RootTrack];
+
+	// Distance along the root motion path on the ground plane or yaw turned, constant tracks store a single key
+	TArray<float> Distances;
+	Distances.SetNumUninitialized(NumFrames);
+	Distances[0] = 0.f;
+
+	if (Phase == EDistanceCurvePhase::Turn)
+	{
+		const TArray<FQuat>& RotKeys = Track.RotKeys;
+		if (RotKeys.Num() == 0)
+		{
+			OutError = TEXT("has no root rotation keys");
+			return false;
+		}
+
+		for (int32 Frame = 1; Frame < NumFrames; Frame++)
+		{
+			const float PreviousYaw = RotKeys[FMath::Min(Frame - 1, RotKeys.Num() - 1)].Rotator().Yaw;
+			const float CurrentYaw = RotKeys[FMath::Min(Frame, RotKeys.Num() - 1)].Rotator().Yaw;
+			Distances[Frame] = Distances[Frame - 1] + FMath::FindDeltaAngleDegrees(PreviousYaw, CurrentYaw);
+		}
+
+		// Turns to the left measure the same as turns to the right
+		if (Distances.Last() < 0.f)
+		{
+			for (float& Distance : Distances)
+			{
+				Distance = -Distance;
+			}
+		}
+	}
+	else
+	{
+		const TArray<FVector>& PosKeys = Track.PosKeys;
+		if (PosKeys.Num() == 0)
+		{
+			OutError = TEXT("has no root translation keys");
+			return false;
+		}
+
+		for (int32 Frame = 1; Frame < NumFrames; Frame++)
+		{
+			const FVector& Previous = PosKeys[FMath::Min(Frame - 1, PosKeys.Num() - 1)];
+			const FVector& Current = PosKeys[FMath::Min(Frame, PosKeys.Num() - 1)];
+			Distances[Frame] = Distances[Frame - 1] + FVector::Dist2D(Previous, Current);
+		}
+	}
+
+	const float TotalDistance = Distances.Last();
+	if (TotalDistance < MinDistanceStep)
+	{
+		OutError = TEXT("root does not move");
+		return false;
+	}
+
+	const float FrameTime = Sequence->GetPlayLength() / (NumFrames - 1);
+	const float DistanceOffset = Phase == EDistanceCurvePhase::Start ? 0.f : -TotalDistance;
+
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		const float Value = Distances[Frame] + DistanceOffset;
+		if (OutKeys.Num() == 0 || Value - OutKeys.Last().Value >= MinDistanceStep)
+		{
+			OutKeys.Add(FRichCurveKey(Frame * FrameTime, Value));
+		}
+	}
+
+	if (OutKeys.Num() < 2)
+	{
+		OutError = TEXT("moves less than the minimum distance step per frame");
+		return false;
+	}
+
+	return true;
+}
+
+bool DistanceCurveGenerator::WriteCurve(UAnimSequence* Sequence, FName CurveName, const TArray<FRichCurveKey>& Keys)
+{
+	check(IsInGameThread());
+
+	USkeleton* Skeleton = Sequence->GetSkeleton();
+	if (!Skeleton)
+	{
+		return false;
+	}
+
+	FSmartName SmartName;
+	if (!Skeleton->GetSmartNameByName(USkeleton::AnimCurveMappingName, CurveName, SmartName))
+	{
+		Skeleton->AddSmartNameAndModify(USkeleton::AnimCurveMappingName, CurveName, SmartName);
+	}
+
+	Sequence->Modify();
+
+	FFloatCurve* Curve = static_cast<FFloatCurve*>(Sequence->RawCurveData.GetCurveData(SmartName.UID, ERawCurveTrackTypes::RCT_Float));
+	if (!Curve)
+	{
+		Sequence->RawCurveData.AddCurveData(SmartName);
+		Curve = static_cast<FFloatCurve*>(Sequence->RawCurveData.GetCurveData(SmartName.UID, ERawCurveTrackTypes::RCT_Float));
+	}
+
+	if (!Curve)
+	{
+		return false;
+	}
+
+	Curve->FloatCurve.Reset();
+	Curve->FloatCurve.SetKeys(Keys);
+
+	Sequence->MarkRawDataAsModified();
+	Sequence->PostEditChange();
+	Sequence->MarkPackageDirty();
+	return true;
+}
+
+int32 DistanceCurveGenerator::Generate(const TArray<UAnimSequence*>& Sequences, const FDistanceCurveGeneratorSettings& Settings)
+{
+	struct FResult
+	{
+		EDistanceCurvePhase Phase;
+		TArray<FRichCurveKey> Keys;
+		FString Error;
+		bool bSuccess;
+	};
+
+	TArray<FResult> Results;
+	Results.SetNum(Sequences.Num());
+
+	ParallelFor(Sequences.Num(), [&Sequences, &Settings, &Results](int32 Index)
+	{
+		FResult& Result = Results[Index];
+		Result.Phase = GetPhase(Sequences[Index], Settings.Phase);
+		Result.bSuccess = ComputeKeys(Sequences[Index], Result.Phase, Settings.MinDistanceStep, Result.Keys, Result.Error);
+	});
+
+	int32 NumWritten = 0;
+	for (int32 Index = 0; Index < Sequences.Num(); Index++)
+	{
+		UAnimSequence* Sequence = Sequences[Index];
+		const FResult& Result = Results[Index];
+
+		if (!Result.bSuccess)
+		{
+			// Loops and idles in the same folder are expected
+			if (Result.Phase == EDistanceCurvePhase::Auto)
+			{
+				UE_LOG(LogDistanceCurveGenerator, Display, TEXT("Skipped %s, it %s"), *Sequence->GetPathName(), *Result.Error);
+			}
+			else
+			{
+				UE_LOG(LogDistanceCurveGenerator, Warning, TEXT("Skipped %s, it %s"), *Sequence->GetPathName(), *Result.Error);
+			}
+			continue;
+		}
+
+		const bool bTurn = Result.Phase == EDistanceCurvePhase::Turn;
+		const FName CurveName = bTurn ? Settings.TurnCurveName : Settings.CurveName;
+		if (!WriteCurve(Sequence, CurveName, Result.Keys))
+		{
+			UE_LOG(LogDistanceCurveGenerator, Warning, TEXT("Could not write curve '%s' to %s"), *CurveName.ToString(), *Sequence->GetPathName());
+			continue;
+		}
+
+		UE_LOG(LogDistanceCurveGenerator, Display, TEXT("Wrote %s curve '%s' with %d keys to %s, %.1f %s"),
+			bTurn ? TEXT("turn") : Result.Phase == EDistanceCurvePhase::Start ? TEXT("start") : TEXT("stop"), *CurveName.ToString(), Result.Keys.Num(), *Sequence->GetPathName(),
+			FMath::Abs(Result.Keys.Last().Value - Result.Keys[0].Value), bTurn ? TEXT("degrees") : TEXT("cm"));
+		NumWritten++;
+	}
+
+	return NumWritten;
+}
@@ -0,0 +1,125 @@
+#include "GenerateDistanceCurvesCommandlet.h"
+#include "DistanceCurveGenerator.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGenerateDistanceCurves, Log, All);
+
+UGenerateDistanceCurvesCommandlet::UGenerateDistanceCurvesCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGenerateDistanceCurvesCommandlet::Main(const FString& Params)
+{
+	FString Path;
+	if (!FParse::Value(*Params, TEXT("Path="), Path))
+	{
+		UE_LOG(LogGenerateDistanceCurves, Error, TEXT("Missing -Path=<content folder>"));
+		return 1;
+	}
+
+	FDistanceCurveGeneratorSettings Settings;
+
+	FString CurveName;
+	if (FParse::Value(*Params, TEXT("CurveName="), CurveName))
+	{
+		Settings.CurveName = *CurveName;
+	}
+
+	FString TurnCurveName;
+	if (FParse::Value(*Params, TEXT("TurnCurveName="), TurnCurveName))
+	{
+		Settings.TurnCurveName = *TurnCurveName;
+	}
+
+	FString Phase;
+	if (FParse::Value(*Params, TEXT("Phase="), Phase))
+	{
+		if (Phase == TEXT("Start"))
+		{
+			Settings.Phase = EDistanceCurvePhase::Start;
+		}
+		else if (Phase == TEXT("Stop"))
+		{
+			Settings.Phase = EDistanceCurvePhase::Stop;
+		}
+		else if (Phase == TEXT("Turn"))
+		{
+			Settings.Phase = EDistanceCurvePhase::Turn;
+		}
+		else if (Phase != TEXT("Auto"))
+		{
+			UE_LOG(LogGenerateDistanceCurves, Error, TEXT("Unknown -Phase=%s, expected Auto, Start, Stop or Turn"), *Phase);
+			return 1;
+		}
+	}
+
+	FParse::Value(*Params, TEXT("MinDistanceStep="), Settings.MinDistanceStep);
+	const bool bSave = !FParse::Param(*Params, TEXT("NoSave"));
+
+	// The registry is not populated in commandlets
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.PackagePaths.Add(*Path);
+	Filter.bRecursivePaths = true;
+	Filter.ClassNames.Add(UAnimSequence::StaticClass()->GetFName());
+	Filter.bRecursiveClasses = true;
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	TArray<UAnimSequence*> Sequences;
+	for (const FAssetData& Asset : Assets)
+	{
+		if (UAnimSequence* Sequence = Cast<UAnimSequence>(Asset.GetAsset()))
+		{
+			Sequences.Add(Sequence);
+		}
+	}
+
+	UE_LOG(LogGenerateDistanceCurves, Display, TEXT("Found %d sequences under %s"), Sequences.Num(), *Path);
+
+	const int32 NumWritten = DistanceCurveGenerator::Generate(Sequences, Settings);
+
+	int32 NumFailedSaves = 0;
+	if (bSave)
+	{
+		// Skeletons are dirty when the curve name was added to them
+		TSet<UPackage*> Packages;
+		for (UAnimSequence* Sequence : Sequences)
+		{
+			Packages.Add(Sequence->GetOutermost());
+			if (USkeleton* Skeleton = Sequence->GetSkeleton())
+			{
+				Packages.Add(Skeleton->GetOutermost());
+			}
+		}
+
+		for (UPackage* Package : Packages)
+		{
+			if (!Package->IsDirty())
+			{
+				continue;
+			}
+
+			const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+			if (!UPackage::SavePackage(Package, nullptr, RF_Standalone, *Filename))
+			{
+				UE_LOG(LogGenerateDistanceCurves, Error, TEXT("Could not save %s"), *Filename);
+				NumFailedSaves++;
+			}
+		}
+	}
+
+	UE_LOG(LogGenerateDistanceCurves, Display, TEXT("Wrote %d of %d sequences%s"), NumWritten, Sequences.Num(), bSave ? TEXT("") : TEXT(", not saved"));
+	return NumFailedSaves > 0 ? 1 : 0;
+}
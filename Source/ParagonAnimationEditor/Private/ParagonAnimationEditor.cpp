@@ -1,18 +1,123 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "ParagonAnimationEditor.h"
+#include "DistanceCurveRegistry.h"
+#include "AimOffsetPoseCache.h"
+#include "Editor.h"
+#include "Subsystems/ImportSubsystem.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Animation/AnimSequence.h"
+#include "DistanceCurveGenerator.h"
+#include "ContentBrowserModule.h"
+#include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Widgets/Notifications/SNotificationList.h"
+#include "ScopedTransaction.h"
 
 #define LOCTEXT_NAMESPACE "FParagonAnimationEditorModule"
 
 void FParagonAnimationEditorModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	FCoreDelegates::OnPostEngineInit.AddRaw(this, &FParagonAnimationEditorModule::OnPostEngineInit);
+
+	if (!IsRunningCommandlet())
+	{
+		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>(TEXT("ContentBrowser"));
+		TArray<FContentBrowserMenuExtender_SelectedAssets>& Extenders = ContentBrowserModule.GetAllAssetViewContextMenuExtenders();
+		Extenders.Add(FContentBrowserMenuExtender_SelectedAssets::CreateRaw(this, &FParagonAnimationEditorModule::OnExtendAssetContextMenu));
+		AssetContextMenuHandle = Extenders.Last().GetHandle();
+	}
 }
 
 void FParagonAnimationEditorModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+
+	if (FContentBrowserModule* ContentBrowserModule = FModuleManager::GetModulePtr<FContentBrowserModule>(TEXT("ContentBrowser")))
+	{
+		ContentBrowserModule->GetAllAssetViewContextMenuExtenders().RemoveAll([this](const FContentBrowserMenuExtender_SelectedAssets& Delegate)
+		{
+			return Delegate.GetHandle() == AssetContextMenuHandle;
+		});
+	}
+
+	if (GEditor)
+	{
+		if (UImportSubsystem* ImportSubsystem = GEditor->GetEditorSubsystem<UImportSubsystem>())
+		{
+			ImportSubsystem->OnAssetReimport.Remove(AssetReimportHandle);
+		}
+	}
+}
+
+void FParagonAnimationEditorModule::OnPostEngineInit()
+{
+	// GEditor does not exist yet when this module starts up
+	if (GEditor)
+	{
+		if (UImportSubsystem* ImportSubsystem = GEditor->GetEditorSubsystem<UImportSubsystem>())
+		{
+			AssetReimportHandle = ImportSubsystem->OnAssetReimport.AddRaw(this, &FParagonAnimationEditorModule::OnAssetReimport);
+		}
+	}
+}
+
+void FParagonAnimationEditorModule::OnAssetReimport(UObject* Asset)
+{
+	if (Cast<UAnimSequenceBase>(Asset))
+	{
+		FDistanceCurveRegistry::Get().Invalidate(Asset);
+		FAimOffsetPoseCache::Get().Invalidate(Asset);
+	}
+}
+
+TSharedRef<FExtender> FParagonAnimationEditorModule::OnExtendAssetContextMenu(const TArray<FAssetData>& SelectedAssets)
+{
+	TSharedRef<FExtender> Extender = MakeShared<FExtender>();
+
+	const bool bHasSequence = SelectedAssets.ContainsByPredicate([](const FAssetData& Asset)
+	{
+		return Asset.GetClass() && Asset.GetClass()->IsChildOf<UAnimSequence>();
+	});
+
+	if (bHasSequence)
+	{
+		Extender->AddMenuExtension(TEXT("GetAssetActions"), EExtensionHook::After, nullptr,
+			FMenuExtensionDelegate::CreateRaw(this, &FParagonAnimationEditorModule::AddAssetContextMenuEntries, SelectedAssets));
+	}
+
+	return Extender;
+}
+
+void FParagonAnimationEditorModule::AddAssetContextMenuEntries(FMenuBuilder& MenuBuilder, TArray<FAssetData> SelectedAssets)
+{
+	MenuBuilder.AddMenuEntry(
+		LOCTEXT("GenerateDistanceCurves", "Generate Distance Curves"),
+		LOCTEXT("GenerateDistanceCurves_Tooltip", "Write a DistanceCurve from root motion to the selected start and stop sequences and a TurnCurve to turn sequences"),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateRaw(this, &FParagonAnimationEditorModule::GenerateDistanceCurves, SelectedAssets)));
+}
+
+void FParagonAnimationEditorModule::GenerateDistanceCurves(TArray<FAssetData> SelectedAssets)
+{
+	TArray<UAnimSequence*> Sequences;
+	for (const FAssetData& Asset : SelectedAssets)
+	{
+		if (UAnimSequence* Sequence = Cast<UAnimSequence>(Asset.GetAsset()))
+		{
+			Sequences.Add(Sequence);
+		}
+	}
+
+	const FScopedTransaction Transaction(LOCTEXT("GenerateDistanceCurvesTransaction", "Generate Distance Curves"));
+	const int32 NumWritten = DistanceCurveGenerator::Generate(Sequences, FDistanceCurveGeneratorSettings());
+
+	FNotificationInfo Info(FText::Format(LOCTEXT("GenerateDistanceCurvesResult", "Generated distance curves for {0} of {1} sequences, see the output log for skipped ones"), NumWritten, Sequences.Num()));
+	Info.ExpireDuration = 5.f;
+	FSlateNotificationManager::Get().AddNotification(Info);
 }
 
 #undef LOCTEXT_NAMESPACE
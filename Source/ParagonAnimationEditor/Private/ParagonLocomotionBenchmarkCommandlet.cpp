@@ -0,0 +1,290 @@
+#include "ParagonLocomotionBenchmarkCommandlet.h"
+#include "ParagonAnimationBenchmark.h"
+#include "ParagonAnimInstance.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogParagonBenchmark, Log, All);
+
+namespace
+{
+	const TCHAR* DefaultCharacterClass = TEXT("/ParagonAnimation/Blueprints/ParagonCharacter.ParagonCharacter_C");
+
+	/** Length of one loop of the script in seconds */
+	const float ScriptLength = 8.f;
+
+	/** Movement input and turn rate of a character at Time into its script, relative to its facing */
+	void GetScriptedInput(float Time, FVector& OutInput, float& OutYawRate)
+	{
+		const float T = FMath::Fmod(Time, ScriptLength);
+
+		OutInput = FVector::ZeroVector;
+		OutYawRate = 0.f;
+
+		if (T < 1.f)
+		{
+			// Idle
+		}
+		else if (T < 3.f)
+		{
+			// Start and jog forward
+			OutInput = FVector::ForwardVector;
+		}
+		else if (T < 4.5f)
+		{
+			// Strafe right
+			OutInput = FVector::RightVector;
+		}
+		else if (T < 5.5f)
+		{
+			// Stop
+		}
+		else if (T < 7.f)
+		{
+			// Jog while turning
+			OutInput = FVector::ForwardVector;
+			OutYawRate = 90.f;
+		}
+		else
+		{
+			// Stop
+		}
+	}
+
+	/** Nearest rank percentile of sorted values */
+	double Percentile(const TArray<double>& SortedValues, double P)
+	{
+		if (SortedValues.Num() == 0)
+		{
+			return 0.0;
+		}
+
+		const int32 Rank = FMath::Clamp(FMath::CeilToInt(P / 100.0 * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+		return SortedValues[Rank];
+	}
+
+	struct FBenchmarkColumn
+	{
+		FString Name;
+		TArray<double> Values;
+	};
+}
+
+UParagonLocomotionBenchmarkCommandlet::UParagonLocomotionBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParagonLocomotionBenchmarkCommandlet::Main(const FString& Params)
+{
+#if PARAGON_WITH_BENCHMARK
+	int32 NumCharacters = 100;
+	int32 NumFrames = 600;
+	int32 NumWarmupFrames = 60;
+	float DeltaTime = 1.f / 30.f;
+	FString CharacterClassPath = DefaultCharacterClass;
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("ParagonLocomotionBenchmark.csv");
+
+	FParse::Value(*Params, TEXT("Characters="), NumCharacters);
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Warmup="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+	FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	NumCharacters = FMath::Max(NumCharacters, 1);
+	NumFrames = FMath::Max(NumFrames, 1);
+	NumWarmupFrames = FMath::Max(NumWarmupFrames, 0);
+
+	UClass* CharacterClass = LoadClass<ACharacter>(nullptr, *CharacterClassPath);
+	if (!CharacterClass)
+	{
+		UE_LOG(LogParagonBenchmark, Error, TEXT("Could not load character class %s"), *CharacterClassPath);
+		return 1;
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ParagonLocomotionBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// Without an authority game mode BeginPlay is never dispatched to the actors and their tick functions are never registered
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	// Floor for the characters to walk on
+	if (UStaticMesh* PlaneMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Plane.Plane")))
+	{
+		AStaticMeshActor* Floor = World->SpawnActor<AStaticMeshActor>(FVector::ZeroVector, FRotator::ZeroRotator);
+		Floor->GetStaticMeshComponent()->SetStaticMesh(PlaneMesh);
+		Floor->SetActorScale3D(FVector(1000.f, 1000.f, 1.f));
+	}
+
+	// Characters stand on a grid and start their script at different times
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumCharacters));
+	const float GridSpacing = 400.f;
+
+	TArray<ACharacter*> Characters;
+	TArray<float> ScriptOffsets;
+	for (int32 Index = 0; Index < NumCharacters; Index++)
+	{
+		const FVector Location((Index % GridSize - GridSize / 2) * GridSpacing, (Index / GridSize - GridSize / 2) * GridSpacing, 100.f);
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ACharacter* Character = World->SpawnActor<ACharacter>(CharacterClass, Location, FRotator::ZeroRotator, SpawnParameters);
+		if (!Character)
+		{
+			continue;
+		}
+
+		// Nothing is rendered, keep the meshes updating and evaluating anyway
+		Character->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+		Character->GetCharacterMovement()->bRunPhysicsWithNoController = true;
+
+		if (Index == 0 && !Cast<UParagonAnimInstance>(Character->GetMesh()->GetAnimInstance()))
+		{
+			UE_LOG(LogParagonBenchmark, Warning, TEXT("%s does not use a UParagonAnimInstance, only the distance matching nodes will be measured"), *CharacterClassPath);
+		}
+
+		Characters.Add(Character);
+		ScriptOffsets.Add(FMath::Fmod(Index * 0.37f, ScriptLength));
+	}
+
+	UE_LOG(LogParagonBenchmark, Display, TEXT("Running %d characters for %d frames after %d warmup frames"), Characters.Num(), NumFrames, NumWarmupFrames);
+
+	FBenchmarkColumn Columns[] =
+	{
+		{ TEXT("FrameMs") },
+		{ TEXT("InstanceUpdateMs") },
+		{ TEXT("NodeUpdateMs") },
+		{ TEXT("NodeEvaluateMs") },
+	};
+
+	float ScriptTime = 0.f;
+	for (int32 Frame = 0; Frame < NumWarmupFrames + NumFrames; Frame++)
+	{
+		for (int32 Index = 0; Index < Characters.Num(); Index++)
+		{
+			ACharacter* Character = Characters[Index];
+
+			FVector Input;
+			float YawRate;
+			GetScriptedInput(ScriptTime + ScriptOffsets[Index], Input, YawRate);
+
+			if (YawRate != 0.f)
+			{
+				Character->AddActorWorldRotation(FRotator(0.f, YawRate * DeltaTime, 0.f));
+			}
+
+			if (!Input.IsZero())
+			{
+				Character->AddMovementInput(Character->GetActorRotation().RotateVector(Input), 1.f);
+			}
+		}
+
+		const bool bRecord = Frame >= NumWarmupFrames;
+		FParagonBenchmark::bEnabled = bRecord;
+		FParagonBenchmark::Reset();
+
+		const double FrameStart = FPlatformTime::Seconds();
+		World->Tick(LEVELTICK_All, DeltaTime);
+		const double FrameMs = (FPlatformTime::Seconds() - FrameStart) * 1000.0;
+
+		GFrameCounter++;
+		ScriptTime += DeltaTime;
+
+		if (bRecord)
+		{
+			Columns[0].Values.Add(FrameMs);
+			Columns[1].Values.Add(FParagonBenchmark::GetMilliseconds(EParagonBenchmarkScope::InstanceUpdate));
+			Columns[2].Values.Add(FParagonBenchmark::GetMilliseconds(EParagonBenchmarkScope::NodeUpdate));
+			Columns[3].Values.Add(FParagonBenchmark::GetMilliseconds(EParagonBenchmarkScope::NodeEvaluate));
+		}
+	}
+
+	FParagonBenchmark::bEnabled = false;
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	// Per frame values
+	FString FramesCsv = TEXT("Frame");
+	for (const FBenchmarkColumn& Column : Columns)
+	{
+		FramesCsv += TEXT(",") + Column.Name;
+	}
+	FramesCsv += LINE_TERMINATOR;
+
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		FramesCsv += FString::FromInt(Frame);
+		for (const FBenchmarkColumn& Column : Columns)
+		{
+			FramesCsv += FString::Printf(TEXT(",%.4f"), Column.Values[Frame]);
+		}
+		FramesCsv += LINE_TERMINATOR;
+	}
+
+	// Distribution of every column
+	FString SummaryCsv = FString::Printf(TEXT("Characters,%d,Frames,%d,DeltaTime,%.4f%s"), Characters.Num(), NumFrames, DeltaTime, LINE_TERMINATOR);
+	SummaryCsv += TEXT("Column,Mean,P50,P90,P95,P99,Max");
+	SummaryCsv += LINE_TERMINATOR;
+
+	for (FBenchmarkColumn& Column : Columns)
+	{
+		double Sum = 0.0;
+		for (double Value : Column.Values)
+		{
+			Sum += Value;
+		}
+
+		Column.Values.Sort();
+
+		const double Mean = Sum / Column.Values.Num();
+		SummaryCsv += FString::Printf(TEXT("%s,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f%s"), *Column.Name, Mean,
+			Percentile(Column.Values, 50.0), Percentile(Column.Values, 90.0), Percentile(Column.Values, 95.0), Percentile(Column.Values, 99.0),
+			Column.Values.Last(), LINE_TERMINATOR);
+
+		UE_LOG(LogParagonBenchmark, Display, TEXT("%-18s mean %.4f p50 %.4f p95 %.4f p99 %.4f max %.4f ms"), *Column.Name, Mean,
+			Percentile(Column.Values, 50.0), Percentile(Column.Values, 95.0), Percentile(Column.Values, 99.0), Column.Values.Last());
+	}
+
+	const FString SummaryPath = FPaths::GetPath(OutputPath) / FPaths::GetBaseFilename(OutputPath) + TEXT("_Summary.csv");
+	if (!FFileHelper::SaveStringToFile(FramesCsv, *OutputPath) || !FFileHelper::SaveStringToFile(SummaryCsv, *SummaryPath))
+	{
+		UE_LOG(LogParagonBenchmark, Error, TEXT("Could not write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogParagonBenchmark, Display, TEXT("Wrote %s and %s"), *OutputPath, *SummaryPath);
+
+	// A world that never ticked the characters records nothing, fail instead of reporting zeros
+	for (const FBenchmarkColumn* Column : { &Columns[2], &Columns[3] })
+	{
+		// Sorted above, the last value is the largest
+		if (Column->Values.Last() <= 0.0)
+		{
+			UE_LOG(LogParagonBenchmark, Error, TEXT("No time was recorded in %s, the anim graphs did not run"), *Column->Name);
+			return 1;
+		}
+	}
+
+	return 0;
+#else
+	UE_LOG(LogParagonBenchmark, Error, TEXT("Benchmark scopes are compiled out of this build"));
+	return 1;
+#endif // PARAGON_WITH_BENCHMARK
+}
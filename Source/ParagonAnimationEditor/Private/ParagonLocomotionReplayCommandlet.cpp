@@ -0,0 +1,220 @@
+#include "ParagonLocomotionReplayCommandlet.h"
+#include "ParagonLocomotionRecording.h"
+#include "DistanceCurveRegistry.h"
+#include "Animation/AnimSequenceBase.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Crc.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogParagonReplay, Log, All);
+
+namespace
+{
+	/** One recording being replayed and the state it drives */
+	struct FReplayTrack
+	{
+		FString Name;
+		TArray<FParagonLocomotionRecordedFrame> Frames;
+
+		/** What the instance had when the recording started */
+		FParagonLocomotionState InitialState;
+		FParagonLocomotionFixedStep InitialFixedStep;
+
+		FParagonLocomotionState State;
+		FParagonLocomotionFixedStep FixedStep;
+		FDistanceCurveHandle StartCurve;
+		FDistanceCurveHandle StopCurve;
+	};
+
+	/** Fold the parameters the anim graph reads into the checksum */
+	uint32 HashState(const FParagonLocomotionState& State, float MatchedTime, uint32 Crc)
+	{
+		const float Values[] = { State.Lean, State.AimYaw, State.AimPitch, State.DistanceMachingStart, State.DistanceMachingStop, State.RootYawOffset, MatchedTime };
+		const uint8 Flags[] = { State.IsAccelerating, State.IsMoving, (uint8)State.CardinalDirection };
+		Crc = FCrc::MemCrc32(Values, sizeof(Values), Crc);
+		return FCrc::MemCrc32(Flags, sizeof(Flags), Crc);
+	}
+
+	void FindRecordings(const FString& Path, TArray<FString>& OutFiles)
+	{
+		if (IFileManager::Get().DirectoryExists(*Path))
+		{
+			IFileManager::Get().FindFiles(OutFiles, *(Path / (FString(TEXT("*")) + ParagonLocomotionRecording::FileExtension)), true, false);
+			for (FString& File : OutFiles)
+			{
+				File = Path / File;
+			}
+		}
+		else
+		{
+			OutFiles.Add(Path);
+		}
+	}
+
+	/** Nearest rank percentile of sorted values */
+	double Percentile(const TArray<double>& SortedValues, double P)
+	{
+		if (SortedValues.Num() == 0)
+		{
+			return 0.0;
+		}
+
+		const int32 Rank = FMath::Clamp(FMath::CeilToInt(P / 100.0 * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+		return SortedValues[Rank];
+	}
+}
+
+UParagonLocomotionReplayCommandlet::UParagonLocomotionReplayCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParagonLocomotionReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingPath;
+	if (!FParse::Value(*Params, TEXT("Recording="), RecordingPath))
+	{
+		UE_LOG(LogParagonReplay, Error, TEXT("Missing -Recording=<File or directory>"));
+		return 1;
+	}
+
+	int32 NumIterations = 1;
+	FString StartPath;
+	FString StopPath;
+	FString CurveName = TEXT("DistanceCurve");
+	FString ExpectedChecksum;
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("ParagonLocomotionReplay.csv");
+
+	FParse::Value(*Params, TEXT("Iterations="), NumIterations);
+	FParse::Value(*Params, TEXT("Start="), StartPath);
+	FParse::Value(*Params, TEXT("Stop="), StopPath);
+	FParse::Value(*Params, TEXT("CurveName="), CurveName);
+	FParse::Value(*Params, TEXT("Checksum="), ExpectedChecksum);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	NumIterations = FMath::Max(NumIterations, 1);
+
+	// Sequences are optional, without them only the locomotion update is replayed
+	UAnimSequenceBase* StartSequence = StartPath.IsEmpty() ? nullptr : LoadObject<UAnimSequenceBase>(nullptr, *StartPath);
+	UAnimSequenceBase* StopSequence = StopPath.IsEmpty() ? nullptr : LoadObject<UAnimSequenceBase>(nullptr, *StopPath);
+	if ((!StartPath.IsEmpty() && !StartSequence) || (!StopPath.IsEmpty() && !StopSequence))
+	{
+		UE_LOG(LogParagonReplay, Error, TEXT("Could not load the start or stop sequence"));
+		return 1;
+	}
+
+	TArray<FString> Files;
+	FindRecordings(RecordingPath, Files);
+
+	TArray<FReplayTrack> Tracks;
+	int32 NumFrames = 0;
+	for (const FString& File : Files)
+	{
+		FReplayTrack Track;
+		Track.Name = FPaths::GetBaseFilename(File);
+		if (!ParagonLocomotionRecording::Load(File, Track.InitialState, Track.InitialFixedStep, Track.Frames))
+		{
+			UE_LOG(LogParagonReplay, Warning, TEXT("%s is not a locomotion recording"), *File);
+			continue;
+		}
+
+		NumFrames = FMath::Max(NumFrames, Track.Frames.Num());
+		Tracks.Add(MoveTemp(Track));
+	}
+
+	if (Tracks.Num() == 0 || NumFrames == 0)
+	{
+		UE_LOG(LogParagonReplay, Error, TEXT("No frames to replay in %s"), *RecordingPath);
+		return 1;
+	}
+
+	UE_LOG(LogParagonReplay, Display, TEXT("Replaying %d recordings of up to %d frames %d times"), Tracks.Num(), NumFrames, NumIterations);
+
+	const FName CurveFName(*CurveName);
+	TArray<double> FrameMs;
+	FrameMs.Init(0.0, NumFrames);
+	uint32 Checksum = 0;
+
+	for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+	{
+		// Every iteration starts over so the checksum does not depend on the iteration count
+		Checksum = 0;
+		for (FReplayTrack& Track : Tracks)
+		{
+			Track.State = Track.InitialState;
+			Track.FixedStep = Track.InitialFixedStep;
+		}
+
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			const double FrameStart = FPlatformTime::Seconds();
+
+			for (FReplayTrack& Track : Tracks)
+			{
+				if (Frame >= Track.Frames.Num())
+				{
+					continue;
+				}
+
+				const FParagonLocomotionRecordedFrame& Recorded = Track.Frames[Frame];
+				if (!Recorded.Input.bIsValid)
+				{
+					continue;
+				}
+
+				ParagonLocomotion::UpdateFixedStep(Track.State, Track.FixedStep, Recorded.Settings, Recorded.Input, Recorded.DeltaSeconds);
+
+				// The lookup a distance matching node makes for the current phase
+				float MatchedTime = 0.f;
+				if (Track.State.IsAccelerating && StartSequence)
+				{
+					Track.StartCurve.Update(StartSequence, CurveFName, nullptr, FDistanceCurveTable::DefaultNumSamples);
+					MatchedTime = Track.StartCurve.Evaluate(Track.State.DistanceMachingStart);
+				}
+				else if (!Track.State.IsAccelerating && StopSequence)
+				{
+					Track.StopCurve.Update(StopSequence, CurveFName, nullptr, FDistanceCurveTable::DefaultNumSamples);
+					MatchedTime = Track.StopCurve.Evaluate(Track.State.DistanceMachingStop);
+				}
+
+				Checksum = HashState(Track.State, MatchedTime, Checksum);
+			}
+
+			FrameMs[Frame] += (FPlatformTime::Seconds() - FrameStart) * 1000.0 / NumIterations;
+		}
+	}
+
+	// Per frame values, averaged over the iterations
+	FString FramesCsv = TEXT("Frame,FrameMs");
+	FramesCsv += LINE_TERMINATOR;
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		FramesCsv += FString::Printf(TEXT("%d,%.4f%s"), Frame, FrameMs[Frame], LINE_TERMINATOR);
+	}
+
+	if (!FFileHelper::SaveStringToFile(FramesCsv, *OutputPath))
+	{
+		UE_LOG(LogParagonReplay, Error, TEXT("Could not write %s"), *OutputPath);
+		return 1;
+	}
+
+	TArray<double> SortedMs = FrameMs;
+	SortedMs.Sort();
+	UE_LOG(LogParagonReplay, Display, TEXT("FrameMs p50 %.4f p95 %.4f p99 %.4f max %.4f, wrote %s"),
+		Percentile(SortedMs, 50.0), Percentile(SortedMs, 95.0), Percentile(SortedMs, 99.0), SortedMs.Last(), *OutputPath);
+
+	const FString ChecksumString = FString::Printf(TEXT("%08x"), Checksum);
+	UE_LOG(LogParagonReplay, Display, TEXT("Checksum %s"), *ChecksumString);
+
+	if (!ExpectedChecksum.IsEmpty() && ExpectedChecksum != ChecksumString)
+	{
+		UE_LOG(LogParagonReplay, Error, TEXT("Checksum %s does not match the expected %s, the replayed parameters changed"), *ChecksumString, *ExpectedChecksum);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "EdGraph/EdGraphNodeUtils.h"
+#include "AnimGraphNode_AssetPlayerBase.h"
+#include "AnimNode_AngleMatching.h"
+#include "AnimGraphNode_AngleMatching.generated.h"
+
+UCLASS()
+class UAnimGraphNode_AngleMatching : public UAnimGraphNode_AssetPlayerBase
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, Category = Settings)
+	FAnimNode_AngleMatching Node;
+
+	// UEdGraphNode interface
+	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
+	virtual FText GetTooltipText() const override;
+	// End of UEdGraphNode
+
+	// UAnimGraphNode_Base interface
+	virtual void ValidateAnimNodeDuringCompilation(class USkeleton* ForSkeleton, class FCompilerResultsLog& MessageLog) override;
+	virtual void PreloadRequiredAssets() override;
+	virtual void BakeDataDuringCompilation(class FCompilerResultsLog& MessageLog) override;
+	virtual FString GetNodeCategory() const override;
+	virtual UAnimationAsset* GetAnimationAsset() const override;
+	virtual void GetAllAnimationSequencesReferred(TArray<UAnimationAsset*>& AnimationAssets) const override;
+	virtual void ReplaceReferredAnimations(const TMap<UAnimationAsset*, UAnimationAsset*>& AnimAssetReplacementMap) override;
+	virtual EAnimAssetHandlerType SupportsAssetClass(const UClass* AssetClass) const override;
+	// End of UAnimGraphNode_Base
+
+	// UAnimGraphNode_AssetPlayerBase interface
+	virtual void SetAnimationAsset(UAnimationAsset* Asset) override;
+	// End of UAnimGraphNode_AssetPlayerBase interface
+
+private:
+	/** Constructing FText strings can be costly, so we cache the node's title */
+	FNodeTextCache CachedNodeTitle;
+};
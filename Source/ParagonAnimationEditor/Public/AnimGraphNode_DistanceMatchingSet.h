@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "AnimGraphNode_Base.h"
+#include "AnimNode_DistanceMatchingSet.h"
+#include "AnimGraphNode_DistanceMatchingSet.generated.h"
+
+UCLASS()
+class UAnimGraphNode_DistanceMatchingSet : public UAnimGraphNode_Base
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, Category = Settings)
+	FAnimNode_DistanceMatchingSet Node;
+
+	// UEdGraphNode interface
+	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
+	virtual FText GetTooltipText() const override;
+	// End of UEdGraphNode
+
+	// UAnimGraphNode_Base interface
+	virtual void ValidateAnimNodeDuringCompilation(class USkeleton* ForSkeleton, class FCompilerResultsLog& MessageLog) override;
+	virtual void PreloadRequiredAssets() override;
+	virtual FString GetNodeCategory() const override;
+	virtual void GetAllAnimationSequencesReferred(TArray<UAnimationAsset*>& AnimationAssets) const override;
+	virtual void ReplaceReferredAnimations(const TMap<UAnimationAsset*, UAnimationAsset*>& AnimAssetReplacementMap) override;
+	// End of UAnimGraphNode_Base
+
+private:
+	void GetAllSequences(TArray<UAnimSequenceBase*>& OutSequences) const;
+};
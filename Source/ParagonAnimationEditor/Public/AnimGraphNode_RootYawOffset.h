@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "AnimGraphNode_Base.h"
+#include "AnimNode_RootYawOffset.h"
+#include "AnimGraphNode_RootYawOffset.generated.h"
+
+UCLASS()
+class UAnimGraphNode_RootYawOffset : public UAnimGraphNode_Base
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, Category = Settings)
+	FAnimNode_RootYawOffset Node;
+
+	// UEdGraphNode interface
+	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
+	virtual FText GetTooltipText() const override;
+	virtual FLinearColor GetNodeTitleColor() const override;
+	// End of UEdGraphNode
+
+	// UAnimGraphNode_Base interface
+	virtual FString GetNodeCategory() const override;
+	// End of UAnimGraphNode_Base
+};
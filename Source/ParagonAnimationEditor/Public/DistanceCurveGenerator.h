@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/RichCurve.h"
+
+class UAnimSequence;
+
+/** Which distance the generated curve measures */
+enum class EDistanceCurvePhase : uint8
+{
+	/** Start or Stop from the sequence name, other sequences are skipped */
+	Auto,
+	/** Positive distance travelled since the first frame, like UParagonAnimInstance::DistanceMachingStart */
+	Start,
+	/** Negative distance left to the last frame, like UParagonAnimInstance::DistanceMachingStop */
+	Stop,
+	/** Negative root yaw left to turn to the last frame in degrees, like UParagonAnimInstance::RemainingTurnYaw */
+	Turn,
+};
+
+struct FDistanceCurveGeneratorSettings
+{
+	FName CurveName;
+
+	/** Curve written to turn sequences */
+	FName TurnCurveName;
+
+	EDistanceCurvePhase Phase;
+
+	/** Frames that move less than this, in cm or degrees, are dropped so the curve strictly increases */
+	float MinDistanceStep;
+
+	FDistanceCurveGeneratorSettings();
+};
+
+/** Writes distance curves computed from the root bone track of sequences */
+namespace DistanceCurveGenerator
+{
+	/** Resolve Auto from the sequence name, returns Auto if the name says none of them */
+	EDistanceCurvePhase GetPhase(const UAnimSequence* Sequence, EDistanceCurvePhase Phase);
+
+	/** Compute the curve keys from the raw root track, touches no shared state so it can run on any thread */
+	bool ComputeKeys(const UAnimSequence* Sequence, EDistanceCurvePhase Phase, float MinDistanceStep, TArray<FRichCurveKey>& OutKeys, FString& OutError);
+
+	/** Replace the curve on the sequence and mark its package dirty, game thread only */
+	bool WriteCurve(UAnimSequence* Sequence, FName CurveName, const TArray<FRichCurveKey>& Keys);
+
+	/** Compute the curves of all sequences in parallel then write them, returns the number of sequences written */
+	int32 Generate(const TArray<UAnimSequence*>& Sequences, const FDistanceCurveGeneratorSettings& Settings);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GenerateDistanceCurvesCommandlet.generated.h"
+
+/**
+ * Generates distance curves from root motion for every sequence under a content folder and saves them.
+ *
+ * UE4Editor-Cmd <Project> -run=GenerateDistanceCurves -Path=/ParagonAnimation/Retargeting/Countess
+ *     [-CurveName=DistanceCurve] [-TurnCurveName=TurnCurve] [-Phase=Auto|Start|Stop|Turn] [-MinDistanceStep=0.1] [-NoSave]
+ */
+UCLASS()
+class UGenerateDistanceCurvesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UGenerateDistanceCurvesCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End of UCommandlet interface
+};
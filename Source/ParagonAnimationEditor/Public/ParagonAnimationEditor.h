@@ -12,4 +12,16 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	void OnPostEngineInit();
+	void OnAssetReimport(UObject* Asset);
+
+	/** Content browser actions on selected sequences */
+	TSharedRef<class FExtender> OnExtendAssetContextMenu(const TArray<struct FAssetData>& SelectedAssets);
+	void AddAssetContextMenuEntries(class FMenuBuilder& MenuBuilder, TArray<struct FAssetData> SelectedAssets);
+	void GenerateDistanceCurves(TArray<struct FAssetData> SelectedAssets);
+
+	FDelegateHandle AssetReimportHandle;
+	FDelegateHandle AssetContextMenuHandle;
 };
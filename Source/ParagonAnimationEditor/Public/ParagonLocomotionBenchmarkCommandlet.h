@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParagonLocomotionBenchmarkCommandlet.generated.h"
+
+/**
+ * Spawns characters in an empty world, drives them with a scripted start, jog, strafe, stop and turn loop
+ * and writes the per frame cost of the locomotion update and the distance matching nodes to CSV.
+ *
+ * UE4Editor-Cmd <Project> -run=ParagonLocomotionBenchmark -nullrhi -unattended
+ *     [-Characters=100] [-Frames=600] [-Warmup=60] [-DeltaTime=0.0333]
+ *     [-Character=/ParagonAnimation/Blueprints/ParagonCharacter.ParagonCharacter_C]
+ *     [-Output=<Saved>/Profiling/ParagonLocomotionBenchmark.csv]
+ *
+ * Besides the per frame CSV, a <Output>_Summary.csv with the mean and percentiles of every column is written.
+ */
+UCLASS()
+class UParagonLocomotionBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UParagonLocomotionBenchmarkCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End of UCommandlet interface
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParagonLocomotionReplayCommandlet.generated.h"
+
+/**
+ * Replays locomotion recordings written by UParagonAnimInstance::StartRecording or Paragon.RecordLocomotion
+ * through the same locomotion update and distance curve lookups the anim instance and nodes run, without a world,
+ * pawn or movement component. All recordings advance together, one frame of every recording per replayed frame.
+ *
+ * UE4Editor-Cmd <Project> -run=ParagonLocomotionReplay -nullrhi -unattended -Recording=<File or directory>
+ *     [-Iterations=1] [-Start=<Sequence>] [-Stop=<Sequence>] [-CurveName=DistanceCurve] [-Checksum=<Hex>]
+ *     [-Output=<Saved>/Profiling/ParagonLocomotionReplay.csv]
+ *
+ * The checksum of the replayed parameters is logged, passing it back with -Checksum fails the run when the results changed.
+ */
+UCLASS()
+class UParagonLocomotionReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UParagonLocomotionReplayCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End of UCommandlet interface
+};
@@ -0,0 +1,351 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "ParagonCore/DistanceCurve.h"
+#include "ParagonCore/StopPrediction.h"
+#include "ParagonCore/CardinalDirection.h"
+#include "ParagonCore/FeatureIndex.h"
+#include "ParagonCore/BlendStack.h"
+#include "ParagonCore/TurnInPlace.h"
+
+using namespace ParagonCore;
+
+namespace
+{
+	/** Start clip style curve, distance grows with the square of the time */
+	std::vector<FCurveKey> MakeAcceleratingCurve(int NumKeys, float Length = 1.f, float EndDistance = 200.f)
+	{
+		std::vector<FCurveKey> Keys(NumKeys);
+		for (int KeyIndex = 0; KeyIndex < NumKeys; KeyIndex++)
+		{
+			const float Alpha = (float)KeyIndex / (NumKeys - 1);
+			Keys[KeyIndex].Time = Alpha * Length;
+			Keys[KeyIndex].Value = Alpha * Alpha * EndDistance;
+		}
+		return Keys;
+	}
+
+	std::vector<float> MakeFeatures(int NumPoints, int NumDimensions, unsigned Seed)
+	{
+		std::mt19937 Random(Seed);
+		std::uniform_real_distribution<float> Distribution(-100.f, 100.f);
+		std::vector<float> Points(NumPoints * NumDimensions);
+		for (float& Value : Points)
+		{
+			Value = Distribution(Random);
+		}
+		return Points;
+	}
+}
+
+TEST(DistanceCurve, ReturnsKeyTimesAtKeyDistances)
+{
+	const std::vector<FCurveKey> Keys = MakeAcceleratingCurve(16);
+	for (const FCurveKey& Key : Keys)
+	{
+		EXPECT_NEAR(FindPositionFromDistanceCurve(Keys.data(), (int)Keys.size(), Key.Value), Key.Time, 1.e-5f);
+	}
+}
+
+TEST(DistanceCurve, InterpolatesBetweenKeys)
+{
+	const FCurveKey Keys[] = { { 0.f, 0.f }, { 1.f, 100.f }, { 2.f, 150.f } };
+	EXPECT_FLOAT_EQ(FindPositionFromDistanceCurve(Keys, 3, 50.f), 0.5f);
+	EXPECT_FLOAT_EQ(FindPositionFromDistanceCurve(Keys, 3, 125.f), 1.5f);
+}
+
+TEST(DistanceCurve, ExtrapolatesOutsideOfTheKeys)
+{
+	const FCurveKey Keys[] = { { 0.f, 0.f }, { 1.f, 100.f }, { 2.f, 150.f } };
+	EXPECT_FLOAT_EQ(FindPositionFromDistanceCurve(Keys, 3, -50.f), -0.5f);
+	EXPECT_FLOAT_EQ(FindPositionFromDistanceCurve(Keys, 3, 175.f), 2.5f);
+}
+
+TEST(DistanceCurve, NeedsTwoKeys)
+{
+	const FCurveKey Key = { 1.f, 10.f };
+	EXPECT_EQ(FindPositionFromDistanceCurve(&Key, 1, 10.f), 0.f);
+}
+
+TEST(DistanceCurve, QuantizedTableMatchesTheCurve)
+{
+	const std::vector<FCurveKey> Keys = MakeAcceleratingCurve(64);
+	const int NumSamples = 512;
+	const float MinDistance = Keys.front().Value;
+	const float MaxDistance = Keys.back().Value;
+	const float DistanceStep = (MaxDistance - MinDistance) / (NumSamples - 1);
+
+	std::vector<float> Times(NumSamples);
+	for (int SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+	{
+		Times[SampleIndex] = FindPositionFromDistanceCurve(Keys.data(), (int)Keys.size(), MinDistance + SampleIndex * DistanceStep);
+	}
+
+	std::vector<uint16_t> QuantizedTimes(NumSamples);
+	const FTimeQuantization Quantization = QuantizeTimes(Times.data(), NumSamples, QuantizedTimes.data());
+	EXPECT_FLOAT_EQ(Quantization.TimeOffset, 0.f);
+	EXPECT_NEAR(Quantization.TimeScale * 65535.f, 1.f, 1.e-5f);
+
+	// Exact at the samples up to quantization, the resampling error between samples shrinks with the sample count
+	for (int SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+	{
+		const float Distance = MinDistance + SampleIndex * DistanceStep;
+		EXPECT_NEAR(EvaluateQuantizedTable(QuantizedTimes.data(), NumSamples, Quantization, MinDistance, 1.f / DistanceStep, Distance), Times[SampleIndex], Quantization.TimeScale);
+	}
+
+	for (float Distance = MinDistance; Distance <= MaxDistance; Distance += 0.37f)
+	{
+		EXPECT_NEAR(EvaluateQuantizedTable(QuantizedTimes.data(), NumSamples, Quantization, MinDistance, 1.f / DistanceStep, Distance),
+			FindPositionFromDistanceCurve(Keys.data(), (int)Keys.size(), Distance), 0.005f);
+	}
+}
+
+TEST(DistanceCurve, QuantizesConstantTimes)
+{
+	const float Times[] = { 0.5f, 0.5f, 0.5f };
+	uint16_t QuantizedTimes[3];
+	const FTimeQuantization Quantization = QuantizeTimes(Times, 3, QuantizedTimes);
+	EXPECT_EQ(Quantization.TimeScale, 0.f);
+	EXPECT_FLOAT_EQ(EvaluateQuantizedTable(QuantizedTimes, 3, Quantization, 0.f, 1.f, 1.5f), 0.5f);
+}
+
+TEST(CardinalDirection, ClassifiesByInputAngle)
+{
+	EXPECT_EQ(ClassifyCardinalDirection(0.f, 0.f).Direction, ECardinalDirection::North);
+	EXPECT_EQ(ClassifyCardinalDirection(-69.f, 0.f).Direction, ECardinalDirection::North);
+	EXPECT_EQ(ClassifyCardinalDirection(69.f, 0.f).Direction, ECardinalDirection::North);
+	EXPECT_EQ(ClassifyCardinalDirection(90.f, 0.f).Direction, ECardinalDirection::East);
+	EXPECT_EQ(ClassifyCardinalDirection(-90.f, 0.f).Direction, ECardinalDirection::West);
+	EXPECT_EQ(ClassifyCardinalDirection(180.f, 0.f).Direction, ECardinalDirection::South);
+	EXPECT_EQ(ClassifyCardinalDirection(-120.f, 0.f).Direction, ECardinalDirection::South);
+}
+
+TEST(CardinalDirection, WrapsAroundTheActorYaw)
+{
+	EXPECT_EQ(ClassifyCardinalDirection(170.f, -170.f).Direction, ECardinalDirection::North);
+	EXPECT_EQ(ClassifyCardinalDirection(-100.f, 170.f).Direction, ECardinalDirection::East);
+}
+
+TEST(CardinalDirection, OffsetsTheMeshTowardsTheInput)
+{
+	EXPECT_FLOAT_EQ(ClassifyCardinalDirection(30.f, 0.f).MeshYawOffset, 30.f);
+	EXPECT_FLOAT_EQ(ClassifyCardinalDirection(100.f, 0.f).MeshYawOffset, 10.f);
+	EXPECT_FLOAT_EQ(ClassifyCardinalDirection(-80.f, 0.f).MeshYawOffset, 10.f);
+	EXPECT_FLOAT_EQ(ClassifyCardinalDirection(170.f, 0.f).MeshYawOffset, -10.f);
+}
+
+TEST(StopPrediction, ClosedFormMatchesTheSimulation)
+{
+	const float TimeSteps[] = { 1.f / 60.f, 0.05f };
+	const float Frictions[] = { 0.5f, 1.f, 2.f, 4.f, 8.f, 20.f };
+	const float Decelerations[] = { 0.f, 256.f, 512.f, 1024.f, 2048.f, 4096.f };
+	const float Speeds[] = { 5.f, 50.f, 150.f, 300.f, 600.f, 1200.f };
+
+	for (float TimeStep : TimeSteps)
+	{
+		for (float Friction : Frictions)
+		{
+			for (float Deceleration : Decelerations)
+			{
+				for (float Speed : Speeds)
+				{
+					const FVector3 Velocity(Speed, 0.f, 0.f);
+					FVector3 Simulated;
+					FVector3 ClosedForm;
+					const bool bSimulated = PredictStopLocation(Simulated, FVector3(), Velocity, FVector3(), Friction, Deceleration, TimeStep, 100, false);
+					const bool bClosedForm = PredictStopLocation(ClosedForm, FVector3(), Velocity, FVector3(), Friction, Deceleration, TimeStep, 100, true);
+
+					SCOPED_TRACE(testing::Message() << "TimeStep " << TimeStep << " Friction " << Friction << " Deceleration " << Deceleration << " Speed " << Speed);
+					ASSERT_EQ(bSimulated, bClosedForm);
+					if (bSimulated)
+					{
+						EXPECT_NEAR(ClosedForm.X, Simulated.X, std::max(Simulated.X * 0.01f, 1.f));
+						EXPECT_EQ(ClosedForm.Y, 0.f);
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST(StopPrediction, CountsIterations)
+{
+	FVector3 StopLocation;
+	int Iterations = 0;
+	ASSERT_TRUE(PredictStopLocation(StopLocation, FVector3(), FVector3(600.f, 0.f, 0.f), FVector3(), 2.f, 2048.f, 1.f / 60.f, 100, false, &Iterations));
+	EXPECT_GT(Iterations, 1);
+
+	ASSERT_TRUE(PredictStopLocation(StopLocation, FVector3(), FVector3(600.f, 0.f, 0.f), FVector3(), 2.f, 2048.f, 1.f / 60.f, 100, true, &Iterations));
+	EXPECT_EQ(Iterations, 1);
+}
+
+TEST(StopPrediction, DoesNotStopWhileAcceleratingAlongTheVelocity)
+{
+	FVector3 StopLocation;
+	EXPECT_FALSE(PredictStopLocation(StopLocation, FVector3(), FVector3(300.f, 0.f, 0.f), FVector3(100.f, 0.f, 0.f), 2.f, 2048.f, 1.f / 60.f, 100));
+}
+
+TEST(StopPrediction, NeedsFrictionOrAcceleration)
+{
+	FVector3 StopLocation;
+	EXPECT_FALSE(PredictStopLocation(StopLocation, FVector3(), FVector3(300.f, 0.f, 0.f), FVector3(), 0.f, 2048.f, 1.f / 60.f, 100));
+	EXPECT_FALSE(PredictStopLocation(StopLocation, FVector3(), FVector3(300.f, 0.f, 0.f), FVector3(), 2.f, 2048.f, 0.f, 100));
+}
+
+TEST(StopPrediction, StopsAgainstOpposingAcceleration)
+{
+	FVector3 StopLocation;
+	ASSERT_TRUE(PredictStopLocation(StopLocation, FVector3(10.f, 20.f, 30.f), FVector3(300.f, 0.f, 0.f), FVector3(-2048.f, 0.f, 0.f), 8.f, 2048.f, 1.f / 60.f, 100));
+	EXPECT_GT(StopLocation.X, 10.f);
+	EXPECT_FLOAT_EQ(StopLocation.Y, 20.f);
+	EXPECT_FLOAT_EQ(StopLocation.Z, 30.f);
+}
+
+TEST(StopPrediction, EstimateUsesConstantDeceleration)
+{
+	const FVector3 StopLocation = EstimateStopLocation(FVector3(0.f, 0.f, 50.f), FVector3(0.f, 400.f, 100.f), 1000.f);
+	EXPECT_FLOAT_EQ(StopLocation.X, 0.f);
+	EXPECT_FLOAT_EQ(StopLocation.Y, 80.f);
+	EXPECT_FLOAT_EQ(StopLocation.Z, 50.f);
+}
+
+TEST(FeatureIndex, MatchesTheLinearScan)
+{
+	const int NumDimensions = 8;
+	const int NumPoints = 1000;
+	std::vector<float> Points = MakeFeatures(NumPoints, NumDimensions, 3);
+	const std::vector<float> Queries = MakeFeatures(200, NumDimensions, 5);
+
+	std::vector<uint8_t> SplitDimensions(NumPoints);
+	BuildFeatureIndex(Points.data(), SplitDimensions.data(), NumPoints, NumDimensions);
+
+	for (int QueryIndex = 0; QueryIndex < 200; QueryIndex++)
+	{
+		const float* Query = Queries.data() + QueryIndex * NumDimensions;
+		const FNearestFeature Indexed = FindNearestFeature(Points.data(), SplitDimensions.data(), NumPoints, NumDimensions, Query);
+		const FNearestFeature Linear = FindNearestFeatureLinear(Points.data(), NumPoints, NumDimensions, Query);
+		ASSERT_EQ(Indexed.Index, Linear.Index);
+		EXPECT_EQ(Indexed.DistanceSquared, Linear.DistanceSquared);
+	}
+}
+
+TEST(FeatureIndex, ReportsTheOriginalOrder)
+{
+	const int NumDimensions = 3;
+	const int NumPoints = 64;
+	const std::vector<float> Original = MakeFeatures(NumPoints, NumDimensions, 11);
+	std::vector<float> Points = Original;
+	std::vector<uint8_t> SplitDimensions(NumPoints);
+	std::vector<int> Order(NumPoints);
+	BuildFeatureIndex(Points.data(), SplitDimensions.data(), NumPoints, NumDimensions, Order.data());
+
+	for (int Row = 0; Row < NumPoints; Row++)
+	{
+		for (int Dimension = 0; Dimension < NumDimensions; Dimension++)
+		{
+			EXPECT_EQ(Points[Row * NumDimensions + Dimension], Original[Order[Row] * NumDimensions + Dimension]);
+		}
+	}
+
+	// Every point is its own nearest neighbour
+	for (int Row = 0; Row < NumPoints; Row++)
+	{
+		const FNearestFeature Nearest = FindNearestFeature(Points.data(), SplitDimensions.data(), NumPoints, NumDimensions, Original.data() + Row * NumDimensions);
+		EXPECT_EQ(Order[Nearest.Index], Row);
+		EXPECT_EQ(Nearest.DistanceSquared, 0.f);
+	}
+}
+
+TEST(FeatureIndex, PrunesMostOfTheTree)
+{
+	const int NumDimensions = 4;
+	const int NumPoints = 4096;
+	std::vector<float> Points = MakeFeatures(NumPoints, NumDimensions, 13);
+	const std::vector<float> Queries = MakeFeatures(100, NumDimensions, 17);
+	std::vector<uint8_t> SplitDimensions(NumPoints);
+	BuildFeatureIndex(Points.data(), SplitDimensions.data(), NumPoints, NumDimensions);
+
+	int NumComparisons = 0;
+	for (int QueryIndex = 0; QueryIndex < 100; QueryIndex++)
+	{
+		NumComparisons += FindNearestFeature(Points.data(), SplitDimensions.data(), NumPoints, NumDimensions, Queries.data() + QueryIndex * NumDimensions).NumComparisons;
+	}
+	EXPECT_LT(NumComparisons / 100, NumPoints / 8);
+}
+
+TEST(FeatureIndex, HandlesAnEmptyDatabase)
+{
+	const float Query[] = { 0.f, 0.f };
+	const FNearestFeature Nearest = FindNearestFeature(nullptr, nullptr, 0, 2, Query);
+	EXPECT_EQ(Nearest.Index, -1);
+	EXPECT_EQ(Nearest.NumComparisons, 0);
+}
+
+TEST(BlendStack, BlendsInOverTheSteps)
+{
+	float Weight = 0.f;
+	float OutWeight = 1.f;
+	for (int StepIndex = 0; StepIndex < 4; StepIndex++)
+	{
+		OutWeight *= BlendInWeight(Weight, 0.25f);
+		EXPECT_FLOAT_EQ(Weight + OutWeight, 1.f);
+	}
+	EXPECT_FLOAT_EQ(Weight, 1.f);
+	EXPECT_FLOAT_EQ(OutWeight, 0.f);
+}
+
+TEST(BlendStack, InterruptedClipsFadeOutFromTheirWeight)
+{
+	// A blends out of B, then C interrupts at half way
+	float WeightA = 0.f;
+	float WeightB = 1.f;
+	WeightB *= BlendInWeight(WeightA, 0.5f);
+
+	float WeightC = 0.f;
+	const float Scale = BlendInWeight(WeightC, 0.1f);
+	WeightA *= Scale;
+	WeightB *= Scale;
+
+	EXPECT_FLOAT_EQ(WeightA, 0.45f);
+	EXPECT_FLOAT_EQ(WeightB, 0.45f);
+	EXPECT_FLOAT_EQ(WeightA + WeightB + WeightC, 1.f);
+}
+
+TEST(BlendStack, CutsWithoutABlendTime)
+{
+	float Weight = 0.f;
+	EXPECT_EQ(BlendInWeight(Weight, 1000.f), 0.f);
+	EXPECT_EQ(Weight, 1.f);
+	EXPECT_EQ(BlendInWeight(Weight, 0.f), 0.f);
+	EXPECT_EQ(Weight, 1.f);
+}
+
+TEST(TurnInPlace, CurveYawConsumesTheOffset)
+{
+	// Turn curve holds minus the yaw left to turn, a 90 degree turn played over 30 frames
+	const int NumFrames = 30;
+	for (const float StartOffset : { 90.f, -90.f })
+	{
+		float RootYawOffset = StartOffset;
+		float LastCurveValue = -90.f;
+		for (int Frame = 1; Frame <= NumFrames; Frame++)
+		{
+			const float CurveValue = -90.f * (1.f - (float)Frame / NumFrames);
+			const float Before = RootYawOffset;
+			RootYawOffset = ConsumeTurnYaw(RootYawOffset, CurveValue - LastCurveValue);
+			LastCurveValue = CurveValue;
+
+			EXPECT_LE(std::fabs(RootYawOffset), std::fabs(Before));
+			EXPECT_GE(RootYawOffset * StartOffset, 0.f);
+		}
+		EXPECT_NEAR(RootYawOffset, 0.f, 1e-3f);
+	}
+}
+
+TEST(TurnInPlace, DoesNotTurnPastTheActor)
+{
+	EXPECT_EQ(ConsumeTurnYaw(10.f, 45.f), 0.f);
+	EXPECT_EQ(ConsumeTurnYaw(-10.f, 45.f), 0.f);
+	EXPECT_FLOAT_EQ(ConsumeTurnYaw(-60.f, -15.f), -45.f);
+	EXPECT_FLOAT_EQ(ConsumeTurnYaw(60.f, 0.f), 60.f);
+}